@@ -0,0 +1,104 @@
+/**
+ * \file
+ * \brief Implementation of the allocation counters.
+ */
+
+#include "alloc-counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace school {
+
+  static std::atomic<unsigned long> __allocations    (0);
+  static std::atomic<unsigned long> __deallocations  (0);
+  static std::atomic<unsigned long> __allocated_bytes(0);
+
+  bool counting_allocations() {
+#ifdef SCHOOL_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  allocation_counts current_allocation_counts() {
+    allocation_counts res;
+    res.allocations   = __allocations    .load(std::memory_order_relaxed);
+    res.deallocations = __deallocations  .load(std::memory_order_relaxed);
+    res.bytes         = __allocated_bytes.load(std::memory_order_relaxed);
+    return res;
+  }
+
+#ifdef SCHOOL_COUNT_ALLOCATIONS
+  static void * __allocate(std::size_t n) {
+    __allocations.fetch_add(1, std::memory_order_relaxed);
+    __allocated_bytes.fetch_add(n, std::memory_order_relaxed);
+    return std::malloc(n > 0 ? n : 1);
+  }
+
+  static void __deallocate(void * p) {
+    if (p) {
+      __deallocations.fetch_add(1, std::memory_order_relaxed);
+      std::free(p);
+    }
+  }
+#endif
+
+} // end of namespace school
+
+std::ostream & operator << (std::ostream & os, const school::allocation_counts & c) {
+  return os << c.allocations << " allocations, " << c.deallocations
+            << " deallocations, " << c.bytes << " bytes";
+}
+
+#ifdef SCHOOL_COUNT_ALLOCATIONS
+
+//----- the replaced global operators -----
+
+void * operator new (std::size_t n) {
+  void * p = school::__allocate(n);
+  if (!p) { throw std::bad_alloc(); }
+  return p;
+}
+
+void * operator new [] (std::size_t n) {
+  void * p = school::__allocate(n);
+  if (!p) { throw std::bad_alloc(); }
+  return p;
+}
+
+void * operator new (std::size_t n, const std::nothrow_t &) noexcept {
+  return school::__allocate(n);
+}
+
+void * operator new [] (std::size_t n, const std::nothrow_t &) noexcept {
+  return school::__allocate(n);
+}
+
+void operator delete (void * p) noexcept {
+  school::__deallocate(p);
+}
+
+void operator delete [] (void * p) noexcept {
+  school::__deallocate(p);
+}
+
+void operator delete (void * p, std::size_t) noexcept {
+  school::__deallocate(p);
+}
+
+void operator delete [] (void * p, std::size_t) noexcept {
+  school::__deallocate(p);
+}
+
+void operator delete (void * p, const std::nothrow_t &) noexcept {
+  school::__deallocate(p);
+}
+
+void operator delete [] (void * p, const std::nothrow_t &) noexcept {
+  school::__deallocate(p);
+}
+
+#endif
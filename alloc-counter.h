@@ -0,0 +1,63 @@
+/**
+ * \file
+ * \brief Counting heap allocations.
+ */
+
+#ifndef __SCHOOL_ALLOC_COUNTER_H__
+#define __SCHOOL_ALLOC_COUNTER_H__ 1
+
+#include <iostream>
+
+namespace school {
+
+  /** \brief Number of heap allocations and deallocations and the allocated
+   * bytes, of all threads.
+   */
+  struct allocation_counts {
+
+    unsigned long allocations;
+    unsigned long deallocations;
+    unsigned long bytes;
+
+    allocation_counts() : allocations(0), deallocations(0), bytes(0) {
+    }
+
+    allocation_counts operator + (const allocation_counts & b) const {
+      allocation_counts res;
+      res.allocations   = allocations   + b.allocations;
+      res.deallocations = deallocations + b.deallocations;
+      res.bytes         = bytes         + b.bytes;
+      return res;
+    }
+
+    /** \brief The counts between two snapshots.
+     */
+    allocation_counts operator - (const allocation_counts & b) const {
+      allocation_counts res;
+      res.allocations   = allocations   - b.allocations;
+      res.deallocations = deallocations - b.deallocations;
+      res.bytes         = bytes         - b.bytes;
+      return res;
+    }
+
+  }; // end of struct allocation_counts
+
+  /** \brief True if the global operator new and delete count.
+   *
+   * Counting is switched on at compile time with SCHOOL_COUNT_ALLOCATIONS
+   * ('make DEFS=-DSCHOOL_COUNT_ALLOCATIONS' after a clean), then
+   * alloc-counter.cc replaces the global operator new and delete with
+   * versions that count with relaxed atomics and call malloc and free.
+   * Otherwise the counts stay zero.
+   */
+  bool counting_allocations();
+
+  /** \brief Counts since the start of the program.
+   */
+  allocation_counts current_allocation_counts();
+
+} // end of namespace school
+
+std::ostream & operator << (std::ostream &, const school::allocation_counts &);
+
+#endif
@@ -2,9 +2,14 @@
 #ifndef __SCHOOL_ANALYSER_H__
 #define __SCHOOL_ANALYSER_H__ 1
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 #include "event.h"
 #include "histogram.h"
+#include "histogram-nd.h"
+#include "quantile-sketch.h"
 
 namespace school {
 
@@ -39,6 +44,91 @@ namespace school {
       ++_M_number_of_events;
     }
 
+    /** \brief Analyze a block of n events.
+     *
+     * The default calls analyze() for every event. Derived classes can
+     * override it to process the block in tight (vectorizable) loops.
+     */
+    virtual void analyze_batch(const event * ev, const value_type * weights, size_type n) {
+      for (size_type i = 0; i < n; i++) {
+        this->analyze(ev[i], weights[i]);
+      }
+    }
+
+    /** \brief Analyze a block of n events and increment the counter.
+     */
+    void operator () (const event * ev, const value_type * weights, size_type n)  {
+      this->analyze_batch(ev, weights, n);
+      _M_number_of_events += n;
+    }
+
+    /** \brief A new analyser with the same settings and no results.
+     *
+     * Parallel runs give every worker its own clone and merge the clones at
+     * the end. The default throws std::logic_error.
+     */
+    virtual analyser * clone() const {
+      throw std::logic_error("this analyser cannot be cloned");
+    }
+
+    /** \brief Add the results of another analyser of the same kind.
+     *
+     * The default throws std::logic_error.
+     */
+    virtual void merge_results(const analyser &) {
+      throw std::logic_error("this analyser cannot be merged");
+    }
+
+    /** \brief Add the results and the event counter of another analyser.
+     */
+    void merge(const analyser & ana) {
+      this->merge_results(ana);
+      _M_number_of_events += ana._M_number_of_events;
+    }
+
+    /** \brief Number of doubles in the results of the analyser.
+     *
+     * The results can be written to a flat array of doubles with
+     * store_results() and added to another analyser of the same kind with
+     * add_results(), this is how results cross process boundaries. The
+     * default throws std::logic_error.
+     */
+    virtual size_type results_size() const {
+      throw std::logic_error("this analyser cannot be serialized");
+    }
+
+    /** \brief Write the results to results_size() doubles.
+     */
+    virtual void store_results(value_type *) const {
+      throw std::logic_error("this analyser cannot be serialized");
+    }
+
+    /** \brief Add results written by store_results().
+     */
+    virtual void add_results(const value_type *) {
+      throw std::logic_error("this analyser cannot be serialized");
+    }
+
+    /** \brief Number of doubles in the state, the results and the counter.
+     */
+    size_type state_size() const {
+      return 1 + this->results_size();
+    }
+
+    /** \brief Write the event counter and the results.
+     */
+    void store_state(value_type * out) const {
+      out[0] = static_cast<value_type>(_M_number_of_events);
+      this->store_results(out+1);
+    }
+
+    /** \brief Add the event counter and the results written by store_state().
+     */
+    void add_state(const value_type * in) {
+      _M_number_of_events += static_cast<size_type>(in[0]);
+      this->add_results(in+1);
+    }
+
     /** \brief Print the result.
      *
      * This will be a virtual function, so we need to create only one print
@@ -78,6 +168,63 @@ namespace school {
       _M_weight2_sum += weight*weight;
     }
 
+    /** \brief Analyze a block of events.
+     *
+     * Four independent partial sums, so the compiler can keep them in vector
+     * registers.
+     */
+    void analyze_batch(const event * ev, const value_type * weights, size_type n) {
+      value_type s[4]  = {0.0, 0.0, 0.0, 0.0};
+      value_type s2[4] = {0.0, 0.0, 0.0, 0.0};
+      size_type  i     = 0;
+      size_type  n4    = n - n % 4;
+
+      for (; i < n4; i += 4) {
+        for (size_type l = 0; l < 4; l++) {
+          s [l] += weights[i+l];
+          s2[l] += weights[i+l]*weights[i+l];
+        }
+      }
+
+      for (; i < n; i++) {
+        s [0] += weights[i];
+        s2[0] += weights[i]*weights[i];
+      }
+
+      _M_weight_sum  += (s [0] + s [1]) + (s [2] + s [3]);
+      _M_weight2_sum += (s2[0] + s2[1]) + (s2[2] + s2[3]);
+    }
+
+    /** \brief A new analyser without results.
+     */
+    total_xsection * clone() const {
+      return new total_xsection();
+    }
+
+    /** \brief Add the sums of another total_xsection.
+     */
+    void merge_results(const analyser & ana) {
+      const total_xsection & b = dynamic_cast<const total_xsection &>(ana);
+      _M_weight_sum  += b._M_weight_sum;
+      _M_weight2_sum += b._M_weight2_sum;
+    }
+
+    /** \brief The two sums.
+     */
+    size_type results_size() const {
+      return 2;
+    }
+
+    void store_results(value_type * out) const {
+      out[0] = _M_weight_sum;
+      out[1] = _M_weight2_sum;
+    }
+
+    void add_results(const value_type * in) {
+      _M_weight_sum  += in[0];
+      _M_weight2_sum += in[1];
+    }
+
     /** \brief Print the result.
      */
     std::ostream & print(std::ostream & os) const {
@@ -101,11 +248,27 @@ namespace school {
      */
     histogram _M_hist;
 
+    /** \brief The regular binning, for the batched bin index calculation.
+     */
+    value_type _M_lower, _M_scale;
+
+    /** \brief Scratch space of analyze_batch().
+     */
+    std::vector<value_type>     _M_pT;
+    std::vector<histogram::bin> _M_bins;
+
     // default constructor
-    pT_dist() : _M_hist(
-      "lepton pT distribution",
-      histogram::regular_bin_edges(0.0, 400, 20)
-    ) {
+    pT_dist() : pT_dist(histogram::regular_bin_edges(0.0, 400, 20)) {
+    }
+
+    /** \brief Construct with regular bin edges, the batched binning is taken
+     * from the same edges.
+     */
+    explicit pT_dist(const std::vector<value_type> & edges) :
+    _M_hist ("lepton pT distribution", edges),
+    _M_lower(edges.front()),
+    _M_scale((edges.size() - 1)/(edges.back() - edges.front())),
+    _M_bins (edges.size() - 1) {
     }
 
     pT_dist(const pT_dist &) = default;
@@ -118,9 +281,69 @@ namespace school {
     /** \brief Analyze an event.
      */
     void analyze(const event & p, value_type weight) {
-      value_type pT = p[1].momentum.perp();
+      value_type pT = p.pT(1);
       _M_hist.accumulate(pT, weight);
     }
+
+    /** \brief Analyze a block of events.
+     *
+     * First the pT of the whole block, then the bin indices arithmetically
+     * from the regular binning, then the fills into a local copy of the bins
+     * which is added to the histogram at the end. The bin convention is the
+     * one of histogram::accumulate().
+     */
+    void analyze_batch(const event * ev, const value_type * weights, size_type n) {
+
+      if (_M_pT.size() < n) { _M_pT.resize(n); }
+
+      for (size_type i = 0; i < n; i++) {
+        const lorentzvector & q = ev[i][1].momentum;
+        _M_pT[i] = std::sqrt(q.X()*q.X() + q.Y()*q.Y());
+      }
+
+      for (size_type i = 0; i < n; i++) {
+        value_type t = (_M_pT[i] - _M_lower)*_M_scale;
+        // histogram::accumulate() drops everything below the first upper edge
+        if (t >= 1.0 && t < _M_bins.size()) {
+          _M_bins[static_cast<size_type>(t)].count(weights[i]);
+        }
+      }
+
+      _M_hist.add(_M_bins);
+
+      for (auto & b : _M_bins) {
+        b = histogram::bin();
+      }
+    }
+
+    /** \brief A new analyser without results.
+     */
+    pT_dist * clone() const {
+      pT_dist * res = new pT_dist(*this);
+      res->_M_hist.clear();
+      res->_M_number_of_events = 0;
+      return res;
+    }
+
+    /** \brief Add the histogram of another pT_dist.
+     */
+    void merge_results(const analyser & ana) {
+      _M_hist.add(dynamic_cast<const pT_dist &>(ana)._M_hist);
+    }
+
+    /** \brief The histogram bins.
+     */
+    size_type results_size() const {
+      return _M_hist.state_size();
+    }
+
+    void store_results(value_type * out) const {
+      _M_hist.store_state(out);
+    }
+
+    void add_results(const value_type * in) {
+      _M_hist.add_state(in);
+    }
     
     /** \brief Print the result.
      */
@@ -130,6 +353,261 @@ namespace school {
 
   }; // end of struct pT_dist
 
+  /** \brief Lepton pT versus rapidity.
+   */
+  struct pT_y_dist : analyser {
+
+    /** \brief The histogram.
+     */
+    histogram_nd _M_hist;
+
+    // default constructor
+    pT_y_dist() : _M_hist(
+      "lepton pT vs. rapidity distribution",
+      {axis::regular(0.0, 400, 20), axis::regular(-5.0, 5.0, 20)}
+    ) {
+    }
+
+    pT_y_dist(const pT_y_dist &) = default;
+
+    virtual ~pT_y_dist() {
+    }
+
+    pT_y_dist & operator = (const pT_y_dist &) = default;
+
+    /** \brief Analyze an event.
+     */
+    void analyze(const event & p, value_type weight) {
+      _M_hist.accumulate(p.pT(1), p.rapidity(1), weight);
+    }
+
+    /** \brief A new analyser without results.
+     */
+    pT_y_dist * clone() const {
+      return new pT_y_dist();
+    }
+
+    /** \brief Add the histogram of another pT_y_dist.
+     */
+    void merge_results(const analyser & ana) {
+      _M_hist.add(dynamic_cast<const pT_y_dist &>(ana)._M_hist);
+    }
+
+    /** \brief The histogram bins.
+     */
+    size_type results_size() const {
+      return _M_hist.state_size();
+    }
+
+    void store_results(value_type * out) const {
+      _M_hist.store_state(out);
+    }
+
+    void add_results(const value_type * in) {
+      _M_hist.add_state(in);
+    }
+
+    /** \brief Print the result.
+     */
+    std::ostream & print(std::ostream & os) const {
+      return _M_hist.print(os, _M_number_of_events);
+    }
+
+  }; // end of struct pT_y_dist
+
+  /** \brief Lepton pT distribution with equal statistics bins.
+   *
+   * During the warm-up the pT values are only fed to a quantile sketch. After
+   * the warm-up the sketch gives the bin edges with equal weight per bin,
+   * they are frozen into a flat histogram, and the following events are
+   * filled as usual. Events below or above the range of the warm-up go to an
+   * underflow and an overflow bin, which are printed after the histogram.
+   * The warm-up events are not filled, so the histogram is normalized to the
+   * number of events after the warm-up.
+   */
+  struct adaptive_pT_dist : analyser {
+
+    /** \brief Number of bins.
+     */
+    size_type _M_number_of_bins;
+
+    /** \brief Number of events in the warm-up.
+     */
+    size_type _M_warm_up;
+
+    /** \brief The sketch learning the edges.
+     */
+    quantile_sketch _M_sketch;
+
+    /** \brief The histogram, it has a single dummy bin until it is frozen.
+     */
+    histogram_nd _M_hist;
+
+    /** \brief Range of the frozen binning.
+     */
+    value_type _M_lower, _M_upper;
+
+    /** \brief Events below and above the frozen binning.
+     */
+    histogram::bin _M_underflow, _M_overflow;
+
+    /** \brief Number of events fed to the sketch.
+     *
+     * Kept here, because the event counter of the base class is only
+     * updated after a whole batch.
+     */
+    size_type _M_number_of_warm_up;
+
+    /** \brief Number of events filled into the histogram.
+     */
+    size_type _M_number_of_filled;
+
+    /** \brief True after the warm-up.
+     */
+    bool _M_frozen;
+
+    explicit adaptive_pT_dist(size_type n_bins = 20, size_type warm_up = 10000) :
+    _M_number_of_bins   (n_bins),
+    _M_warm_up          (warm_up > 0 ? warm_up : 1),
+    _M_hist             ("lepton pT distribution (equal statistics bins)", {axis::regular(0.0, 1.0, 1)}),
+    _M_lower            (0.0),
+    _M_upper            (0.0),
+    _M_number_of_warm_up(0),
+    _M_number_of_filled (0),
+    _M_frozen           (false) {
+    }
+
+    adaptive_pT_dist(const adaptive_pT_dist &) = default;
+
+    virtual ~adaptive_pT_dist() {
+    }
+
+    adaptive_pT_dist & operator = (const adaptive_pT_dist &) = default;
+
+    /** \brief True after the warm-up.
+     */
+    bool frozen() const {
+      return _M_frozen;
+    }
+
+    /** \brief Analyze an event.
+     */
+    void analyze(const event & p, value_type weight) {
+
+      value_type pT = p.pT(1);
+
+      if (frozen()) {
+        if      (pT <  _M_lower) { _M_underflow.count(weight);     }
+        else if (pT >= _M_upper) { _M_overflow .count(weight);     }
+        else                     { _M_hist.accumulate(&pT, weight); }
+        ++_M_number_of_filled;
+        return;
+      }
+
+      _M_sketch.add(pT, weight);
+
+      // this was the last warm-up event, freeze the binning
+      if (++_M_number_of_warm_up >= _M_warm_up) {
+        std::vector<value_type> edges = _M_sketch.equal_weight_edges(_M_number_of_bins);
+        _M_hist = histogram_nd(
+          "lepton pT distribution (equal statistics bins)",
+          {axis::variable(edges)}
+        );
+        _M_lower  = edges.front();
+        _M_upper  = edges.back();
+        _M_frozen = true;
+      }
+    }
+
+    /** \brief A new analyser with the same frozen binning and no results.
+     *
+     * The clones must share the binning, so the warm-up has to be finished
+     * before cloning.
+     */
+    adaptive_pT_dist * clone() const {
+      if (!_M_frozen) {
+        throw std::logic_error("adaptive_pT_dist: finish the warm-up before cloning");
+      }
+      adaptive_pT_dist * res = new adaptive_pT_dist(*this);
+      res->_M_hist.clear();
+      res->_M_underflow = res->_M_overflow = histogram::bin();
+      res->_M_number_of_filled = 0;
+      res->_M_number_of_events = 0;
+      return res;
+    }
+
+    /** \brief Add the histogram of another adaptive_pT_dist with the same
+     * binning.
+     */
+    void merge_results(const analyser & ana) {
+      const adaptive_pT_dist & b = dynamic_cast<const adaptive_pT_dist &>(ana);
+      _M_hist.add(b._M_hist);
+      _M_underflow        += b._M_underflow;
+      _M_overflow         += b._M_overflow;
+      _M_number_of_filled += b._M_number_of_filled;
+    }
+
+    /** \brief The number of filled events, the underflow and overflow bins
+     * and the histogram bins, the binning must be frozen.
+     */
+    size_type results_size() const {
+      if (!_M_frozen) {
+        throw std::logic_error("adaptive_pT_dist: finish the warm-up before serializing");
+      }
+      return 5 + _M_hist.state_size();
+    }
+
+    void store_results(value_type * out) const {
+      out[0] = static_cast<value_type>(_M_number_of_filled);
+      out[1] = _M_underflow.sum_of_weights;
+      out[2] = _M_underflow.sum_of_squared_weights;
+      out[3] = _M_overflow .sum_of_weights;
+      out[4] = _M_overflow .sum_of_squared_weights;
+      _M_hist.store_state(out+5);
+    }
+
+    void add_results(const value_type * in) {
+      _M_number_of_filled                 += static_cast<size_type>(in[0]);
+      _M_underflow.sum_of_weights         += in[1];
+      _M_underflow.sum_of_squared_weights += in[2];
+      _M_overflow .sum_of_weights         += in[3];
+      _M_overflow .sum_of_squared_weights += in[4];
+      _M_hist.add_state(in+5);
+    }
+
+    /** \brief Print the result.
+     */
+    std::ostream & print(std::ostream & os) const {
+      if (!frozen()) {
+        return os << "#   lepton pT distribution (equal statistics bins): warm-up not finished" << std::endl;
+      }
+      _M_hist.print(os, _M_number_of_filled);
+      _S_print_outside(os, "underflow, pT < ",  _M_lower, _M_underflow, _M_number_of_filled);
+      _S_print_outside(os, "overflow, pT >= ", _M_upper, _M_overflow,  _M_number_of_filled);
+      return os;
+    }
+
+  private:
+
+    /** \brief Print the integrated cross section and error of an underflow
+     * or overflow bin.
+     */
+    static std::ostream & _S_print_outside(
+      std::ostream         & os,
+      const char           * what,
+      value_type             edge,
+      const histogram::bin & b,
+      size_type              npoints
+    ) {
+      const value_type n = static_cast<value_type>(npoints);
+      return os << "#   " << what << edge << ": "
+                << (n > 0 ? b.sum_of_weights/n : 0.0) << "  "
+                << (n > 0 ? std::sqrt(std::max(0.0, b.sum_of_squared_weights - b.sum_of_weights*b.sum_of_weights/n)/n) : 0.0)
+                << std::endl;
+    }
+
+  }; // end of struct adaptive_pT_dist
+
 } // end of namespace school
 
 /** \brief Print operator for all analyser descendants.
@@ -0,0 +1,110 @@
+/**
+ * \file
+ * \brief A small harness for timing kernels.
+ */
+
+#ifndef __SCHOOL_BENCHMARK_H__
+#define __SCHOOL_BENCHMARK_H__ 1
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace school {
+
+  /** \brief Summary of the repetitions of a benchmark, times in ns per call.
+   */
+  struct benchmark_result {
+
+    typedef std::size_t size_type;
+    typedef double      value_type;
+
+    std::string name;
+    size_type   calls;       ///< calls per repetition
+    size_type   repetitions;
+    value_type  mean;
+    value_type  stddev;
+    value_type  min;
+    value_type  median;
+
+    /** \brief Calls per second, from the median.
+     */
+    value_type rate() const {
+      return median > 0.0 ? 1e9/median : 0.0;
+    }
+
+    /** \brief Print the column names, they start with '#'.
+     */
+    static std::ostream & print_header(std::ostream & os) {
+      return os << "# name ns/call(mean) stddev min median calls/s calls repetitions" << std::endl;
+    }
+
+    /** \brief Print the result as one line of space separated columns.
+     */
+    std::ostream & print(std::ostream & os) const {
+      return os << name << ' '
+                << mean << ' ' << stddev << ' ' << min << ' ' << median << ' '
+                << rate() << ' ' << calls << ' ' << repetitions << std::endl;
+    }
+
+  }; // end of struct benchmark_result
+
+  /** \brief Results of the kernels end up here, so the compiler cannot
+   * throw the kernels away.
+   */
+  extern volatile double _G_benchmark_sink;
+
+  /** \brief Time a kernel.
+   *
+   * The kernel is called with the call number, once per call. A first
+   * repetition warms up the caches and the branch predictors and is not
+   * counted, then every repetition times the given number of calls.
+   */
+  template <class Kernel>
+  benchmark_result benchmark(
+    const std::string & name,
+    std::size_t         calls,
+    std::size_t         repetitions,
+    Kernel              kernel
+  ) {
+    typedef std::chrono::steady_clock clock;
+
+    for (std::size_t i = 0; i < calls; i++) {
+      kernel(i);
+    }
+
+    std::vector<double> t(repetitions);
+
+    for (std::size_t r = 0; r < repetitions; r++) {
+      clock::time_point start = clock::now();
+      for (std::size_t i = 0; i < calls; i++) {
+        kernel(i);
+      }
+      t[r] = std::chrono::duration<double, std::nano>(clock::now() - start).count()/calls;
+    }
+
+    benchmark_result res;
+    res.name        = name;
+    res.calls       = calls;
+    res.repetitions = repetitions;
+
+    double sum = 0.0, sum2 = 0.0;
+    for (double x : t) { sum += x; sum2 += x*x; }
+    res.mean   = sum/repetitions;
+    res.stddev = repetitions > 1 ? std::sqrt(std::max(0.0, (sum2 - sum*res.mean)/(repetitions - 1))) : 0.0;
+
+    std::sort(t.begin(), t.end());
+    res.min    = t.front();
+    res.median = repetitions % 2 ? t[repetitions/2] : 0.5*(t[repetitions/2 - 1] + t[repetitions/2]);
+
+    return res;
+  }
+
+} // end of namespace school
+
+#endif
@@ -0,0 +1,109 @@
+#!/bin/bash
+
+#
+# Performance and physics regression test.
+#
+# Builds sample-app and the benchmarks, runs them and compares the results to
+# a baseline file:
+#
+#   - the total cross section and its error of the default sample-app run
+#     must agree to a relative tolerance, the run is seeded, so any change is
+#     a change of the physics or of the numerics,
+#   - the median ns/call of every benchmark must not grow by more than the
+#     time tolerance,
+#   - the events/s of sample-app must not drop by more than the time
+#     tolerance.
+#
+# Usage (from the top directory):
+#
+#   bench/regression.sh [--update] [--baseline=file] [--time-tolerance=0.25]
+#                       [--xsec-tolerance=1e-5] [--repetitions=10]
+#
+# With --update the baseline is written from this run instead. The timings
+# only make sense on the machine the baseline was made on, so keep one
+# baseline per machine type.
+#
+# Exit status: 0 if everything agrees, 1 on a regression, 2 on other errors.
+#
+# No set -e here: a failing command would exit with its own status, which
+# could be taken for a regression. Every step is checked by hand instead.
+
+fail() {
+  echo "$0: $*" >&2
+  exit 2
+}
+
+BASELINE=bench/baseline.txt
+TIME_TOL=0.25
+XSEC_TOL=1e-5
+REPETITIONS=10
+UPDATE=0
+
+for arg in "$@"; do
+  case $arg in
+    --update)             UPDATE=1 ;;
+    --baseline=*)         BASELINE=${arg#*=} ;;
+    --time-tolerance=*)   TIME_TOL=${arg#*=} ;;
+    --xsec-tolerance=*)   XSEC_TOL=${arg#*=} ;;
+    --repetitions=*)      REPETITIONS=${arg#*=} ;;
+    *) sed -n '/^# Usage/,/^# Exit/p' $0 | sed 's/^# \{0,1\}//'; exit 2 ;;
+  esac
+done
+
+make all bench > /dev/null || fail "build failed"
+
+CURRENT=`mktemp` || fail "cannot make a temporary file"
+KERNELS=`mktemp` || fail "cannot make a temporary file"
+trap "rm -f $CURRENT $KERNELS" EXIT
+
+#----- end-to-end run -----
+START=`date +%s%N`
+OUTPUT=`./sample-app` || fail "sample-app failed"
+STOP=`date +%s%N`
+
+echo "$OUTPUT" | grep -q '^Total cross section is' || fail "no cross section in the sample-app output"
+
+EVENTS=1000000
+echo "$OUTPUT" | awk -v events=$EVENTS -v ns=$((STOP - START)) '
+  /^Total cross section is/ && !done { print "xsection total", $5; print "error total", $7; done = 1 }
+  END { print "rate sample-app", events/(ns*1e-9) }' >> $CURRENT
+
+#----- kernels -----
+bench/school-bench --repetitions=$REPETITIONS > $KERNELS || fail "school-bench failed"
+awk '!/^#/ { print "time", $1, $5 }' $KERNELS >> $CURRENT
+
+if [ $UPDATE = 1 ]; then
+  {
+    echo "# kind name value"
+    echo "# made on `uname -n`, `date -u +%Y-%m-%d`, `${CXX:-c++} --version | head -1`"
+    cat $CURRENT
+  } > $BASELINE || fail "cannot write $BASELINE"
+  echo "baseline written to $BASELINE"
+  exit 0
+fi
+
+[ -f $BASELINE ] || fail "no baseline $BASELINE, make one with --update"
+
+# Compare, one line per entry of the baseline.
+awk -v time_tol=$TIME_TOL -v xsec_tol=$XSEC_TOL '
+  function abs(x) { return x < 0 ? -x : x }
+  FNR == NR { if (!/^#/) current[$1 " " $2] = $3; next }
+  /^#/ { next }
+  {
+    key = $1 " " $2; base = $3
+    if (!(key in current)) { printf "%-40s missing\n", key; failed++; next }
+    cur = current[key]; status = "ok"
+    if ($1 == "xsection" || $1 == "error") {
+      if (abs(cur - base) > xsec_tol*abs(base)) status = "DRIFT"
+    } else if ($1 == "time") {
+      if (cur > base*(1 + time_tol)) status = "SLOWER"
+    } else if ($1 == "rate") {
+      if (cur < base*(1 - time_tol)) status = "SLOWER"
+    }
+    printf "%-40s %14g %14g %+8.1f%%  %s\n", key, base, cur, base ? 100*(cur - base)/base : 0, status
+    if (status != "ok") failed++
+  }
+  END {
+    if (failed) { print failed " regression(s)"; exit 1 }
+    print "no regressions"
+  }' $CURRENT $BASELINE
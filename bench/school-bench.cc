@@ -0,0 +1,226 @@
+/**
+ * \file
+ * \brief Microbenchmarks of the kernels and of the whole event loop.
+ *
+ * Every benchmark prints one line of space separated columns, see
+ * benchmark_result::print_header(), so the output can be stored and compared
+ * between versions.
+ */
+
+#include "benchmark.h"
+
+#include "../analyser.h"
+#include "../histogram.h"
+#include "../histogram-nd.h"
+#include "../mc-integral.h"
+#include "../mc-integral-t.h"
+#include "../mc-scan.h"
+#include "../me-pp-to-llbar.h"
+#include "../me-pp-to-llbar-scan.h"
+#include "../qcd-pdf.h"
+#include "../rambo.h"
+#include "../scan-analyser.h"
+#include "../school-rng.h"
+#include "../sparse-histogram.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace school;
+using namespace std;
+
+namespace school {
+  volatile double _G_benchmark_sink = 0.0;
+}
+
+// Reads the value of a "--name=value" command line option.
+static bool option(const char * arg, const char * name, double & value) {
+  size_t n = strlen(name);
+  if (strncmp(arg, "--", 2) != 0 || strncmp(arg+2, name, n) != 0 || arg[n+2] != '=') {
+    return false;
+  }
+  value = strtod(arg+n+3, 0);
+  return true;
+}
+
+int main(int argc, char ** argv)
+{
+  double repetitions = 10;
+  double scale       = 1;  // multiplies the number of calls
+
+  for (int i = 1; i < argc; i++) {
+    if (option(argv[i], "repetitions", repetitions)) continue;
+    if (option(argv[i], "scale",       scale      )) continue;
+    cerr << "usage: " << argv[0] << " [--repetitions=10] [--scale=1]" << endl;
+    return 1;
+  }
+
+  const size_t reps = repetitions >= 1 ? static_cast<size_t>(repetitions) : 1;
+  auto calls = [scale] (double n) -> size_t {
+    return n*scale >= 1 ? static_cast<size_t>(n*scale) : 1;
+  };
+
+  seed_random_engine(0, 0);
+
+  qcd_hadron       pdf1;
+  qcd_antihadron   pdf2(pdf1);
+  me_pp_to_llbar   me;
+  mc_integral      xsec(14000.0, &pdf1, &pdf2, &me);
+
+  // a sample of events as input to the kernels
+  const size_t       n_events = 1024;
+  vector<event>      events(n_events);
+  vector<double>     weights(n_events);
+  for (size_t k = 0; k < n_events; k++) {
+    weights[k] = xsec.generate(events[k]);
+  }
+
+  benchmark_result::print_header(cout);
+
+  //----- lorentzvector::boost -----
+  benchmark("lorentzvector::boost", calls(1e6), reps, [&] (size_t i) {
+    lorentzvector p = events[i % n_events][1].momentum;
+    p.boost(0.1, -0.2, 0.3);
+    _G_benchmark_sink = p.T();
+  }).print(cout);
+
+  //----- rambo, two massless particles -----
+  {
+    event ev = events[0];
+    benchmark("rambo", calls(1e6), reps, [&] (size_t) {
+      _G_benchmark_sink = rambo(1e4, ev.begin()+2, ev.end());
+    }).print(cout);
+  }
+
+  //----- generate_event -----
+  {
+    event ev = events[0];
+    benchmark("generate_event", calls(1e6), reps, [&] (size_t) {
+      _G_benchmark_sink = generate_event(ev, 14000.0);
+    }).print(cout);
+  }
+
+  // The kernels below read the invariant cache of the sample events, which
+  // is invalidated at every call, so its filling is part of the timing as
+  // it is in the event loop.
+
+  //----- me_pp_to_llbar::operator() -----
+  benchmark("me_pp_to_llbar", calls(1e6), reps, [&] (size_t i) {
+    event & ev = events[i % n_events];
+    ev.invalidate_invariants();
+    _G_benchmark_sink = me(ev);
+  }).print(cout);
+
+  //----- qcd_antihadron::parton -----
+  {
+    // the scales are taken beforehand, only the pdf is timed
+    vector<double> shat(n_events);
+    for (size_t k = 0; k < n_events; k++) {
+      shat[k] = events[k].s(-1,0);
+    }
+    benchmark("qcd_antihadron::parton", calls(1e6), reps, [&] (size_t i) {
+      const event & ev = events[i % n_events];
+      _G_benchmark_sink = pdf2.parton(ev[0].flavor, ev.xb, shat[i % n_events]);
+    }).print(cout);
+  }
+
+  //----- histogram::accumulate -----
+  {
+    histogram hist("bench", histogram::regular_bin_edges(0.0, 400, 20));
+    benchmark("histogram::accumulate", calls(1e6), reps, [&] (size_t i) {
+      event & ev = events[i % n_events];
+      ev.invalidate_invariants();
+      hist.accumulate(ev.pT(1), weights[i % n_events]);
+    }).print(cout);
+  }
+
+  //----- histogram_nd::accumulate, pT vs. rapidity -----
+  {
+    histogram_nd hist("bench", {axis::regular(0.0, 400, 20), axis::regular(-5.0, 5.0, 20)});
+    benchmark("histogram_nd::accumulate_2d", calls(1e6), reps, [&] (size_t i) {
+      event & ev = events[i % n_events];
+      ev.invalidate_invariants();
+      hist.accumulate(ev.pT(1), ev.rapidity(1), weights[i % n_events]);
+    }).print(cout);
+  }
+
+  //----- sparse_histogram::accumulate, 1e7 bins -----
+  {
+    // the same O(1) bin lookup as above, plus the page table
+    sparse_histogram hist("bench", axis::regular(0.0, 1e4, 10000000));
+    benchmark("sparse_histogram::accumulate_1e7", calls(1e6), reps, [&] (size_t i) {
+      event & ev = events[i % n_events];
+      ev.invalidate_invariants();
+      hist.accumulate(ev.pT(1), weights[i % n_events]);
+    }).print(cout);
+  }
+
+  //----- whole event loop, one event per call -----
+  {
+    total_xsection tot;
+    pT_dist        pT;
+    benchmark("mc_integral", calls(2e5), reps, [&] (size_t) {
+      xsec({&tot, &pT});
+    }).print(cout);
+    _G_benchmark_sink = tot._M_weight_sum;
+  }
+
+  //----- whole event loop in blocks, 1024 events per call -----
+  {
+    total_xsection tot;
+    pT_dist        pT;
+    benchmark_result res = benchmark("mc_integral_block1024", calls(200), reps, [&] (size_t) {
+      xsec(1024, {&tot, &pT});
+    });
+    // per event, not per block
+    res.mean /= 1024; res.stddev /= 1024; res.min /= 1024; res.median /= 1024;
+    res.print(cout);
+    _G_benchmark_sink = tot._M_weight_sum;
+  }
+
+  //----- the same loops bound statically, to compare with the above -----
+  {
+    qcd_antihadron_t<qcd_hadron> pdf2_t(pdf1);
+    total_xsection               tot;
+    pT_dist                      pT;
+    auto xsec_t = make_mc_integral(14000.0, pdf1, pdf2_t, me, tot, pT);
+
+    benchmark("mc_integral_t", calls(2e5), reps, [&] (size_t) {
+      xsec_t();
+    }).print(cout);
+
+    benchmark_result res = benchmark("mc_integral_t_block1024", calls(200), reps, [&] (size_t) {
+      xsec_t(1024);
+    });
+    res.mean /= 1024; res.stddev /= 1024; res.min /= 1024; res.median /= 1024;
+    res.print(cout);
+    _G_benchmark_sink = tot._M_weight_sum;
+  }
+
+  //----- a 4x4 scan in mB and gB, one event of all grid points per call -----
+  {
+    const vector<resonance_model> grid =
+      me_pp_to_llbar_scan::mass_width_grid(resonance_model(), 250.0, 290.0, 4, 12.0, 22.0, 4);
+
+    me_pp_to_llbar_scan me_scan(grid);
+    mc_scan             scan(14000.0, &pdf1, &pdf2, &me_scan);
+    total_xsection_scan tot_scan(me_scan);
+    benchmark("mc_scan_grid16", calls(2e5/16), reps, [&] (size_t) {
+      scan({&tot_scan});
+    }).print(cout);
+    _G_benchmark_sink = tot_scan._M_weight_sum[0];
+
+    // the same with one plain run per grid point
+    vector<me_pp_to_llbar> mes(grid.begin(), grid.end());
+    vector<mc_integral>    runs;
+    for (auto & m : mes) { runs.push_back(mc_integral(14000.0, &pdf1, &pdf2, &m)); }
+    total_xsection tot;
+    benchmark("mc_integral_x16", calls(2e5/16), reps, [&] (size_t) {
+      for (auto & r : runs) { r({&tot}); }
+    }).print(cout);
+    _G_benchmark_sink = tot._M_weight_sum;
+  }
+
+  return 0;
+}
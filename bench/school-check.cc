@@ -0,0 +1,275 @@
+/**
+ * \file
+ * \brief Correctness checks of the parts which the default sample-app run
+ * does not reach.
+ *
+ * Every check prints one line, "ok name" or "FAILED name: reason". The exit
+ * status is 0 if all checks pass and 1 otherwise.
+ */
+
+#include "../analyser.h"
+#include "../concurrent-histogram.h"
+#include "../concurrent-pT-dist.h"
+#include "../histogram.h"
+#include "../histogram-nd.h"
+#include "../mc-integral.h"
+#include "../mc-scan.h"
+#include "../me-pp-to-llbar.h"
+#include "../me-pp-to-llbar-scan.h"
+#include "../parallel-integral.h"
+#include "../qcd-pdf.h"
+#include "../scan-analyser.h"
+#include "../school-rng.h"
+#include "../sparse-histogram.h"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace school;
+using namespace std;
+
+static int failures = 0;
+
+// Prints the result of a check and counts the failures.
+static void check(const string & name, bool ok, const string & reason = "") {
+  if (ok) {
+    cout << "ok " << name << endl;
+  } else {
+    cout << "FAILED " << name << ": " << reason << endl;
+    ++failures;
+  }
+}
+
+// Compares two flat arrays element by element with a relative tolerance,
+// returns the first difference in reason.
+static bool agree(const vector<double> & a, const vector<double> & b, double tolerance, string & reason) {
+  if (a.size() != b.size()) {
+    reason = "different sizes";
+    return false;
+  }
+  for (size_t k = 0; k < a.size(); k++) {
+    if (std::abs(a[k] - b[k]) > tolerance*std::max(std::abs(a[k]), std::abs(b[k]))) {
+      ostringstream os;
+      os << "element " << k << ": " << a[k] << " != " << b[k];
+      reason = os.str();
+      return false;
+    }
+  }
+  return true;
+}
+
+static vector<double> state_of(const histogram & h) {
+  vector<double> res(h.state_size());
+  h.store_state(res.data());
+  return res;
+}
+
+//----- concurrent_histogram -----
+
+// Several threads fill their shards and the shared shard, the merged result
+// must be the serial fill. The weights are multiples of 1/4, so the sums are
+// exact in any order.
+static void check_concurrent_histogram() {
+
+  const size_t          threads = 4, n = 200000;
+  const vector<double>  edges   = histogram::regular_bin_edges(0.0, 400, 20);
+
+  auto observable = [] (size_t i) { return 0.5 + static_cast<double>((i*37) % 450); };
+  auto weight     = [] (size_t i) { return static_cast<double>(i % 8)/4.0; };
+
+  histogram serial("serial", edges);
+  for (size_t t = 0; t < threads; t++) {
+    for (size_t i = t; i < n; i += threads) {
+      serial.accumulate(observable(i), weight(i));
+      serial.accumulate(observable(i+n), weight(i+n));
+    }
+  }
+
+  concurrent_histogram   shared("concurrent", edges, threads);
+  vector<std::thread>    workers;
+  for (size_t t = 0; t < threads; t++) {
+    workers.push_back(std::thread([&, t] () {
+      for (size_t i = t; i < n; i += threads) {
+        shared.accumulate(t, observable(i), weight(i));
+        shared.accumulate_atomic(observable(i+n), weight(i+n));
+      }
+    }));
+  }
+  for (auto & w : workers) { w.join(); }
+
+  histogram merged("merged", edges);
+  shared.merge_into(merged);
+
+  string reason;
+  check("concurrent_histogram threaded fill = serial fill",
+        agree(state_of(serial), state_of(merged), 0.0, reason), reason);
+}
+
+// The --threads mode of sample-app: the shared pT histogram must give the
+// pT_dist of the same events.
+static void check_concurrent_pT_dist() {
+
+  qcd_hadron        pdf1;
+  qcd_antihadron    pdf2(pdf1);
+  me_pp_to_llbar    me;
+  parallel_integral pxsec(14000.0, &pdf1, &pdf2, &me);
+
+  pT_dist            pT;
+  concurrent_pT_dist cpT(4);
+  pxsec(100000, 1024, 4, {&pT, &cpT});
+
+  check("concurrent_pT_dist events", pT._M_number_of_events == cpT._M_number_of_events,
+        "different event counts");
+
+  // the sums are added in a different order
+  string reason;
+  check("concurrent_pT_dist = pT_dist",
+        agree(state_of(pT._M_hist), state_of(cpT._M_shared->hist.snapshot()), 1e-12, reason), reason);
+}
+
+//----- histogram_nd -----
+
+// Every axis kind must put x into the bin with lower(k) <= x < upper(k), up
+// to rounding at the edges, and nothing outside of the axis.
+static void check_axis(const string & name, const axis & a, double lower, double upper) {
+
+  const double slack = 1e-9*(upper - lower);
+  string       reason;
+  bool         ok = true;
+
+  for (size_t i = 0; i < 100000 && ok; i++) {
+    double    x = lower - 0.1*(upper - lower) + 1.2*(upper - lower)*(i + 0.5)/100000;
+    size_t    k;
+    bool      inside = a.index(x, k);
+    if (inside != (x >= lower && x < upper)) {
+      ok = std::abs(x - lower) < slack || std::abs(x - upper) < slack;
+    } else if (inside && (x < a.lower(k) - slack || x >= a.upper(k) + slack)) {
+      ok = false;
+    }
+    if (!ok) {
+      ostringstream os;
+      os << "x = " << x << " in the wrong bin";
+      reason = os.str();
+    }
+  }
+
+  check("axis " + name, ok, reason);
+}
+
+// The 2 and 3 dimensional fills must be the general one.
+static void check_histogram_nd() {
+
+  check_axis("regular",     axis::regular    (-5.0, 5.0, 20),     -5.0, 5.0);
+  check_axis("logarithmic", axis::logarithmic(1e-3, 1e3, 30),     1e-3, 1e3);
+  check_axis("variable",    axis::variable   ({0.0, 1.0, 1.5, 4.0, 10.0}), 0.0, 10.0);
+
+  const vector<axis> axes = {axis::regular(0.0, 400, 20), axis::regular(-5.0, 5.0, 20),
+                             axis::logarithmic(1.0, 1e4, 8)};
+  histogram_nd h2 ("2d", {axes[0], axes[1]}), g2("2d", {axes[0], axes[1]});
+  histogram_nd h3 ("3d", axes),               g3("3d", axes);
+
+  for (size_t i = 0; i < 100000; i++) {
+    double x[3] = {static_cast<double>((i*37) % 450), -6.0 + 12.0*((i*53) % 1000)/1000, 0.5 + (i*71) % 20000};
+    double w    = static_cast<double>(i % 8)/4.0;
+    h2.accumulate(x[0], x[1], w);
+    g2.accumulate(x, w);
+    h3.accumulate(x[0], x[1], x[2], w);
+    g3.accumulate(x, w);
+  }
+
+  string reason;
+  auto state = [] (const histogram_nd & h) {
+    vector<double> res(h.state_size());
+    h.store_state(res.data());
+    return res;
+  };
+  check("histogram_nd 2d fill = general fill", agree(state(h2), state(g2), 0.0, reason), reason);
+  check("histogram_nd 3d fill = general fill", agree(state(h3), state(g3), 0.0, reason), reason);
+}
+
+//----- sparse_histogram -----
+
+// A 1e7 bin axis filled in a narrow window needs the page table and one
+// page, about 100 KB instead of 160 MB, and prints exactly the filled bins.
+static void check_sparse_histogram() {
+
+  sparse_histogram h("sparse", axis::regular(0.0, 1000.0, 10000000));
+
+  // 100 bins of width 1e-4 from 100 on, all in one page
+  for (size_t i = 0; i < 100000; i++) {
+    h.accumulate(100.0 + 1e-4*((i % 100) + 0.5), 1.0);
+  }
+
+  const size_t table = (h.size() + sparse_histogram::page_size - 1)/sparse_histogram::page_size;
+  const size_t bytes = table*sizeof(void *) + sparse_histogram::page_size*sizeof(histogram::bin);
+
+  ostringstream os;
+  os << "memory " << h.memory() << " bytes, expected " << bytes;
+  check("sparse_histogram 1e7 bins, one page", h.memory() == bytes && bytes < 100*1024, os.str());
+
+  ostringstream out;
+  h.print(out, 100000);
+  size_t lines = 0;
+  for (char c : out.str()) { lines += c == '\n'; }
+  check("sparse_histogram prints the filled bins", lines == 1 + 100, "wrong number of lines");
+}
+
+//----- parameter scan -----
+
+// Every grid point of me_pp_to_llbar_scan must be the me_pp_to_llbar of its
+// model, event by event, and a seeded mc_scan must give the cross section of
+// a seeded mc_integral with that model.
+static void check_scan() {
+
+  const vector<resonance_model> grid =
+    me_pp_to_llbar_scan::mass_width_grid(resonance_model(), 250.0, 290.0, 3, 12.0, 22.0, 2);
+  const size_t point = 4;
+
+  qcd_hadron          pdf1;
+  qcd_antihadron      pdf2(pdf1);
+  me_pp_to_llbar_scan me_scan(grid);
+  me_pp_to_llbar      me(grid[point]);
+
+  seed_random_engine(7, 0);
+  mc_scan             scan(14000.0, &pdf1, &pdf2, &me_scan);
+  total_xsection      tot_scan;
+  scan_point          at_point(point, tot_scan);
+  vector<double>      me2(me_scan.stride());
+  string              reason;
+  bool                ok = true;
+
+  for (size_t i = 0; i < 10000; i++) {
+    scan({&at_point});
+    const event & ev = scan.last_event().second;
+    me_scan(ev, me2.data());
+    for (size_t k = 0; k < grid.size() && ok; k++) {
+      ok = agree({me2[k]}, {me_pp_to_llbar(grid[k])(ev)}, 1e-12, reason);
+    }
+  }
+  check("me_pp_to_llbar_scan = me_pp_to_llbar", ok, reason);
+
+  seed_random_engine(7, 0);
+  mc_integral    xsec(14000.0, &pdf1, &pdf2, &me);
+  total_xsection tot;
+  for (size_t i = 0; i < 10000; i++) {
+    xsec({&tot});
+  }
+  check("mc_scan grid point = mc_integral",
+        agree({tot_scan._M_weight_sum, tot_scan._M_weight2_sum},
+              {tot._M_weight_sum,      tot._M_weight2_sum}, 1e-12, reason), reason);
+}
+
+int main()
+{
+  check_concurrent_histogram();
+  check_concurrent_pT_dist();
+  check_histogram_nd();
+  check_sparse_histogram();
+  check_scan();
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * \file
+ * \brief Thread scaling study of the parallel event loop.
+ *
+ * Runs parallel_integral with 1..N threads and several block sizes and
+ * prints a table with one line per run, columns separated by spaces and the
+ * header starting with '#', ready for plotting:
+ *
+ *  - events/s and the parallel efficiency, events/s over the number of threads
+ *    times the events/s with one thread and the same block size,
+ *  - the cross section and its error, and the figure of merit
+ *    1/(error^2 * cpu seconds), which does not depend on the number of events
+ *    and measures the precision we get for the CPU time.
+ */
+
+#include "../analyser.h"
+#include "../me-pp-to-llbar.h"
+#include "../parallel-integral.h"
+#include "../qcd-pdf.h"
+
+#include <time.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace school;
+using namespace std;
+
+// Reads the value of a "--name=value" command line option.
+static bool option(const char * arg, const char * name, string & value) {
+  size_t n = strlen(name);
+  if (strncmp(arg, "--", 2) != 0 || strncmp(arg+2, name, n) != 0 || arg[n+2] != '=') {
+    return false;
+  }
+  value = arg+n+3;
+  return true;
+}
+
+// CPU time of the whole process in seconds.
+static double cpu_seconds() {
+  timespec t;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+  return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+// A comma separated list of numbers.
+static vector<unsigned long> number_list(const string & text) {
+  vector<unsigned long> res;
+  istringstream         in(text);
+  string                item;
+  while (getline(in, item, ',')) {
+    if (!item.empty()) { res.push_back(strtoul(item.c_str(), 0, 10)); }
+  }
+  return res;
+}
+
+int main(int argc, char ** argv)
+{
+  unsigned long hw = thread::hardware_concurrency();
+
+  string events   = "1000000";
+  string threads  = to_string(hw ? hw : 1);
+  string blocks   = "64,256,1024,4096";
+  string affinity = "none";
+
+  for (int i = 1; i < argc; i++) {
+    if (option(argv[i], "events",   events  )) continue;
+    if (option(argv[i], "threads",  threads )) continue;
+    if (option(argv[i], "blocks",   blocks  )) continue;
+    if (option(argv[i], "affinity", affinity)) continue;
+    cerr << "usage: " << argv[0]
+         << " [--events=1000000] [--threads=max] [--blocks=64,256,1024,4096]"
+         << " [--affinity=none|compact|scatter|cpu,...]" << endl;
+    return 1;
+  }
+
+  const unsigned long n           = strtoul(events.c_str(), 0, 10);
+  const unsigned long max_threads = strtoul(threads.c_str(), 0, 10);
+
+  qcd_hadron       pdf1;
+  qcd_antihadron   pdf2(pdf1);
+  me_pp_to_llbar   me;
+  parallel_integral xsec(14000.0, &pdf1, &pdf2, &me);
+
+  try {
+    xsec.set_affinity(affinity_policy::parse(affinity));
+  } catch (const invalid_argument & error) {
+    cerr << error.what() << endl;
+    return 1;
+  }
+
+  cout << "# threads block events seconds cpu_seconds events/s efficiency"
+          " xsection error fom steals" << endl;
+
+  for (unsigned long block : number_list(blocks)) {
+    double rate1 = 0.0;
+
+    for (unsigned long t = 1; t <= max_threads; t++) {
+      total_xsection tot;
+
+      double                             cpu0  = cpu_seconds();
+      chrono::steady_clock::time_point   wall0 = chrono::steady_clock::now();
+
+      xsec(n, block, t, {&tot});
+
+      double wall = chrono::duration<double>(chrono::steady_clock::now() - wall0).count();
+      double cpu  = cpu_seconds() - cpu0;
+
+      double N     = tot._M_number_of_events;
+      double mean  = tot._M_weight_sum/N;
+      double error = sqrt((tot._M_weight2_sum/N - mean*mean)/N);
+      double rate  = N/wall;
+
+      if (t == 1) { rate1 = rate; }
+
+      cout << t << ' ' << block << ' ' << n << ' ' << wall << ' ' << cpu << ' '
+           << rate << ' ' << rate/(t*rate1) << ' '
+           << mean << ' ' << error << ' ' << 1.0/(error*error*cpu) << ' '
+           << xsec.number_of_steals() << endl;
+    }
+
+    // empty line between the blocks, for gnuplot
+    cout << endl;
+  }
+
+  return 0;
+}
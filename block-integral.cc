@@ -0,0 +1,153 @@
+/**
+ * \file
+ * \brief Implementation of block_integral members.
+ */
+
+#include "block-integral.h"
+
+#include <chrono>
+#include <iomanip>
+
+namespace school {
+
+  // Seconds since the last call, for timing the stages.
+  class __stage_clock {
+
+    std::chrono::steady_clock::time_point _M_last;
+
+  public:
+
+    __stage_clock() : _M_last(std::chrono::steady_clock::now()) {
+    }
+
+    double lap() {
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      double res = std::chrono::duration<double>(now - _M_last).count();
+      _M_last = now;
+      return res;
+    }
+  };
+
+  block_integral::block_integral(
+    value_type             Ecm ,
+    const qcd_hadron_base *pdf1,
+    const qcd_hadron_base *pdf2,
+    const matrix_element  *me  ,
+    const kinematic_cuts  *cuts,
+    size_type              block_size
+  ) :
+  _M_Ecm               (Ecm ),
+  _M_pdf1              (pdf1),
+  _M_pdf2              (pdf2),
+  _M_me                (me  ),
+  _M_cuts              (cuts),
+  _M_block_size        (0),
+  _M_number_of_rejected(0),
+  _M_number_of_events  (0) {
+
+    for (int s = 0; s < number_of_stages; s++) {
+      _M_time[s] = 0.0;
+    }
+
+    set_block_size(block_size);
+  }
+
+  void block_integral::set_block_size(size_type n) {
+    _M_block_size = n > 0 ? n : 1;
+    _TMP_events .resize(_M_block_size);
+    _TMP_weights.resize(_M_block_size);
+    _TMP_shat   .resize(_M_block_size);
+  }
+
+  void block_integral::operator () (size_type n, const std::vector<analyser*> & ah) {
+    for (size_type k = 0; k < n; k += _M_block_size) {
+      block(n - k < _M_block_size ? n - k : _M_block_size, ah);
+    }
+  }
+
+  void block_integral::block(size_type n, const std::vector<analyser*> & ah) {
+
+    event      * ev = _TMP_events.data();
+    value_type * w  = _TMP_weights.data();
+    value_type * sh = _TMP_shat.data();
+
+    __stage_clock clock;
+
+    //----- flavors, this resizes the events -----
+    for (size_type i = 0; i < n; i++) {
+      _M_me->set_flavors(ev[i]);
+    }
+    _M_time[flavor_stage] += clock.lap();
+
+    //----- momenta -----
+    for (size_type i = 0; i < n; i++) {
+      w[i] = generate_event(ev[i], _M_Ecm);
+    }
+    _M_time[phase_space_stage] += clock.lap();
+
+    //----- cuts, rejected events get zero weight and skip the rest -----
+    if (_M_cuts) {
+      for (size_type i = 0; i < n; i++) {
+        if (!_M_cuts->operator()(ev[i])) {
+          w[i] = 0.0;
+          ++_M_number_of_rejected;
+        }
+      }
+    }
+    _M_time[cut_stage] += clock.lap();
+
+    //----- pdfs, for factorization scale we use shat -----
+    // the momenta stay from here on, the const view keeps the invariants
+    const event * cev = ev;
+
+    for (size_type i = 0; i < n; i++) {
+      sh[i] = cev[i].s(-1,0);
+    }
+    for (size_type i = 0; i < n; i++) {
+      if (w[i] != 0.0) { w[i] *= _M_pdf1->parton(cev[i][-1].flavor, cev[i].xa, sh[i]); }
+    }
+    for (size_type i = 0; i < n; i++) {
+      if (w[i] != 0.0) { w[i] *= _M_pdf2->parton(cev[i][ 0].flavor, cev[i].xb, sh[i]); }
+    }
+    _M_time[pdf_stage] += clock.lap();
+
+    //----- matrix element -----
+    for (size_type i = 0; i < n; i++) {
+      if (w[i] != 0.0) { w[i] *= _M_me->operator()(ev[i]); }
+    }
+    _M_time[me_stage] += clock.lap();
+
+    //----- analysis -----
+    for (auto iter : ah) {
+      iter->operator()(ev, w, n);
+    }
+    _M_time[analysis_stage] += clock.lap();
+
+    _M_number_of_events += n;
+  }
+
+  std::ostream & block_integral::print_timings(std::ostream & os) const {
+
+    static const char * names[number_of_stages] = {
+      "flavors", "phase space", "cuts", "pdfs", "matrix element", "analysis"
+    };
+
+    double total = 0.0;
+    for (int s = 0; s < number_of_stages; s++) {
+      total += _M_time[s];
+    }
+
+    os << "#   stage timings, block size " << _M_block_size
+       << ", " << _M_number_of_events << " events: stage  seconds  %  ns/event" << std::endl;
+
+    for (int s = 0; s < number_of_stages; s++) {
+      os << std::setw(16) << std::left << names[s] << std::right << "  "
+         << _M_time[s]                                                       << "  "
+         << (total > 0.0 ? 100.0*_M_time[s]/total : 0.0)                     << "  "
+         << (_M_number_of_events ? 1e9*_M_time[s]/_M_number_of_events : 0.0) << std::endl;
+    }
+
+    return os;
+  }
+
+} // end of namespace school
@@ -0,0 +1,119 @@
+/**
+ * \file
+ * \brief Definition of the block_integral class.
+ */
+
+#ifndef __SCHOOL_BLOCK_INTEGRAL_H__
+#define __SCHOOL_BLOCK_INTEGRAL_H__ 1
+
+#include "event.h"
+#include "matrix-element.h"
+#include "qcd-pdf.h"
+#include "analyser.h"
+#include "cuts.h"
+
+#include <iostream>
+#include <vector>
+
+namespace school {
+
+  /** \brief MC integral processing blocks of events stage by stage.
+   *
+   * mc_integral does everything for one event before it starts the next one.
+   * Here a block of events goes through every stage (flavors, phase space,
+   * cuts, pdfs, matrix element, analysis) before the next stage starts. Each
+   * stage is a tight loop over the block, which keeps its code and data in
+   * the caches and gives the compiler loops to vectorize. The time spent in
+   * every stage is measured per block.
+   */
+  class block_integral {
+
+  public:
+
+    typedef event::value_type value_type;
+    typedef event::size_type  size_type;
+
+    /** \brief The stages of the event loop. */
+    enum stage_type {
+      flavor_stage,
+      phase_space_stage,
+      cut_stage,
+      pdf_stage,
+      me_stage,
+      analysis_stage,
+      number_of_stages
+    };
+
+  private:
+
+    value_type             _M_Ecm;
+    const qcd_hadron_base *_M_pdf1;
+    const qcd_hadron_base *_M_pdf2;
+    const matrix_element  *_M_me;
+    const kinematic_cuts  *_M_cuts; // no cuts if null
+    size_type              _M_block_size;
+    size_type              _M_number_of_rejected;
+
+    /** \brief Accumulated time of every stage in seconds.
+     */
+    double _M_time[number_of_stages];
+
+    /** \brief Number of events processed.
+     */
+    size_type _M_number_of_events;
+
+    // the block
+    std::vector<event>      _TMP_events;
+    std::vector<value_type> _TMP_weights;
+    std::vector<value_type> _TMP_shat;
+
+  public:
+
+    block_integral(
+      value_type             Ecm ,
+      const qcd_hadron_base *pdf1,
+      const qcd_hadron_base *pdf2,
+      const matrix_element  *me  ,
+      const kinematic_cuts  *cuts       = 0,
+      size_type              block_size = 1024
+    );
+
+    /** \brief Events per block.
+     */
+    size_type block_size() const {
+      return _M_block_size;
+    }
+
+    /** \brief Change the number of events per block.
+     */
+    void set_block_size(size_type n);
+
+    /** \brief Number of events rejected by the cuts.
+     */
+    size_type number_of_rejected() const {
+      return _M_number_of_rejected;
+    }
+
+    /** \brief Time spent in a stage so far in seconds.
+     */
+    double time(stage_type s) const {
+      return _M_time[s];
+    }
+
+    /** \brief Generate n events block by block and analyse them.
+     */
+    void operator () (size_type n, const std::vector<analyser*> & ah);
+
+    /** \brief Generate a single block of n <= block_size() events.
+     */
+    void block(size_type n, const std::vector<analyser*> & ah);
+
+    /** \brief Print the time spent in the stages.
+     */
+    std::ostream & print_timings(std::ostream &) const;
+
+  }; // end of class block_integral
+
+} // end of namespace school
+
+#endif
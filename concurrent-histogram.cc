@@ -0,0 +1,63 @@
+/**
+ * \file
+ * \brief Implementation of concurrent_histogram class methods.
+ */
+
+#include "concurrent-histogram.h"
+
+#include <cstdint>
+
+namespace school {
+
+  concurrent_histogram::concurrent_histogram(
+    const std::string             & name,
+    const std::vector<value_type> & edges,
+    size_type                       number_of_shards
+  ) :
+  _M_name            (name),
+  _M_edges           (edges),
+  _M_number_of_shards(number_of_shards),
+  _M_stride          ((2*(edges.size()-1) + line_size - 1) / line_size * line_size),
+  _M_storage         ((number_of_shards+1)*_M_stride + line_size),
+  _M_offset          (0) {
+
+    // align the first shard to a cache line
+    while (reinterpret_cast<std::uintptr_t>(_M_storage.data() + _M_offset) % 64 != 0) {
+      ++_M_offset;
+    }
+
+    clear();
+  }
+
+  void concurrent_histogram::clear() {
+    for (auto & a : _M_storage) {
+      a.store(0.0, std::memory_order_relaxed);
+    }
+  }
+
+  std::vector<histogram::bin> concurrent_histogram::_M_sum() const {
+
+    std::vector<bin> res(size());
+
+    for (size_type s = 0; s <= _M_number_of_shards; s++) {
+      const std::atomic<value_type> * b = _M_shard(s);
+      for (size_type k = 0; k < res.size(); k++) {
+        res[k].sum_of_weights         += b[2*k  ].load(std::memory_order_relaxed);
+        res[k].sum_of_squared_weights += b[2*k+1].load(std::memory_order_relaxed);
+      }
+    }
+
+    return res;
+  }
+
+  histogram concurrent_histogram::snapshot() const {
+    histogram res(_M_name, _M_edges);
+    res.add(_M_sum());
+    return res;
+  }
+
+  void concurrent_histogram::merge_into(histogram & h) const {
+    h.add(_M_sum());
+  }
+
+} // end of namespace school
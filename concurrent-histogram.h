@@ -0,0 +1,172 @@
+/**
+ * \file
+ * \brief Definition of the concurrent_histogram class.
+ */
+
+#ifndef __SCHOOL_CONCURRENT_HISTOGRAM_H__
+#define __SCHOOL_CONCURRENT_HISTOGRAM_H__ 1
+
+#include "histogram.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace school {
+
+  /** \brief Histogram that can be filled from several threads.
+   *
+   * Every worker thread fills its own shard, the shards are padded to whole
+   * cache lines so the workers never write to the same line. A shard has only
+   * one writer, so filling it needs no read-modify-write instruction, only
+   * relaxed atomic loads and stores. For occasional fills from arbitrary
+   * threads there is an extra shared shard updated with compare-and-swap.
+   *
+   * The binning and the bin convention are the same as in histogram, so
+   * merge_into() gives exactly the histogram we would get by filling it
+   * directly.
+   */
+  class concurrent_histogram {
+
+  public:
+
+    typedef histogram::size_type  size_type;
+    typedef histogram::value_type value_type;
+    typedef histogram::bin        bin;
+
+    /** \brief Number of doubles in a cache line.
+     */
+    static const size_type line_size = 64/sizeof(value_type);
+
+  private:
+
+    /** \brief Name of the analysis.
+     */
+    std::string _M_name;
+
+    /** \brief The bin edges.
+     */
+    std::vector<value_type> _M_edges;
+
+    /** \brief Number of worker shards (the shared shard comes after them).
+     */
+    size_type _M_number_of_shards;
+
+    /** \brief Distance between shards in doubles, a multiple of line_size.
+     */
+    size_type _M_stride;
+
+    /** \brief Storage of the shards. Bin k of shard s has its sum of weights
+     * at _M_shard(s)[2*k] and its sum of squared weights at _M_shard(s)[2*k+1].
+     */
+    std::vector<std::atomic<value_type> > _M_storage;
+
+    /** \brief Offset of the first cache line aligned element in _M_storage.
+     */
+    size_type _M_offset;
+
+  public:
+
+    /** \brief Construct giving name, bin boundaries and number of workers.
+     */
+    concurrent_histogram(
+      const std::string             & name,
+      const std::vector<value_type> & edges,
+      size_type                       number_of_shards
+    );
+
+    concurrent_histogram(const concurrent_histogram &)               = delete;
+    concurrent_histogram & operator = (const concurrent_histogram &) = delete;
+
+    /** \brief Number of worker shards.
+     */
+    size_type number_of_shards() const {
+      return _M_number_of_shards;
+    }
+
+    /** \brief Number of bins.
+     */
+    size_type size() const {
+      return _M_edges.size() - 1;
+    }
+
+    /** \brief Accumulate weights into the shard of a worker.
+     *
+     * Only one thread may fill a given shard.
+     */
+    void accumulate(size_type shard, value_type observable, value_type weight) {
+      size_type k;
+      if (!_M_index(observable, k)) { return; }
+
+      std::atomic<value_type> * b = _M_shard(shard) + 2*k;
+      b[0].store(b[0].load(std::memory_order_relaxed) + weight,        std::memory_order_relaxed);
+      b[1].store(b[1].load(std::memory_order_relaxed) + weight*weight, std::memory_order_relaxed);
+    }
+
+    /** \brief Accumulate weights from any thread into the shared shard.
+     */
+    void accumulate_atomic(value_type observable, value_type weight) {
+      size_type k;
+      if (!_M_index(observable, k)) { return; }
+
+      std::atomic<value_type> * b = _M_shard(_M_number_of_shards) + 2*k;
+      _S_add(b[0], weight);
+      _S_add(b[1], weight*weight);
+    }
+
+    /** \brief Current content of all shards as a histogram.
+     *
+     * It can be called while the workers are filling. Then the result may be
+     * a few fills behind, which is good enough for live monitoring.
+     */
+    histogram snapshot() const;
+
+    /** \brief Add the content of all shards to a histogram.
+     *
+     * The histogram must have the same binning. After the workers have
+     * finished this is exact.
+     */
+    void merge_into(histogram &) const;
+
+    /** \brief Set every bin of every shard to zero.
+     */
+    void clear();
+
+  private:
+
+    /** \brief Bin index with the bin convention of histogram::accumulate().
+     */
+    bool _M_index(value_type observable, size_type & k) const {
+      if (observable < _M_edges[1]) { return false; }
+      auto e = std::upper_bound(_M_edges.begin() + 1, _M_edges.end(), observable);
+      if (e == _M_edges.end()) { return false; }
+      k = static_cast<size_type>(e - (_M_edges.begin() + 1));
+      return true;
+    }
+
+    std::atomic<value_type> * _M_shard(size_type s) {
+      return _M_storage.data() + _M_offset + s*_M_stride;
+    }
+
+    const std::atomic<value_type> * _M_shard(size_type s) const {
+      return _M_storage.data() + _M_offset + s*_M_stride;
+    }
+
+    /** \brief Atomic addition for doubles.
+     */
+    static void _S_add(std::atomic<value_type> & a, value_type x) {
+      value_type old = a.load(std::memory_order_relaxed);
+      while (!a.compare_exchange_weak(old, old + x, std::memory_order_relaxed)) {
+      }
+    }
+
+    /** \brief Sum of all shards bin by bin.
+     */
+    std::vector<bin> _M_sum() const;
+
+  }; // end of class concurrent_histogram
+
+} // end of namespace school
+
+#endif
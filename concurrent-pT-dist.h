@@ -0,0 +1,134 @@
+/**
+ * \file
+ * \brief Definition of the concurrent_pT_dist analyser.
+ */
+
+#ifndef __SCHOOL_CONCURRENT_PT_DIST_H__
+#define __SCHOOL_CONCURRENT_PT_DIST_H__ 1
+
+#include "analyser.h"
+#include "concurrent-histogram.h"
+
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace school {
+
+  /** \brief Lepton pT distribution filled by several threads into one
+   * concurrent_histogram.
+   *
+   * The clones share the histogram of the analyser they were made from,
+   * every clone fills its own shard, so the workers of a parallel run need
+   * no histogram copies and merging only adds the event counters. Clones
+   * beyond the number of shards, and the original itself, fill the shared
+   * shard with atomic additions. The binning and the output are the ones of
+   * pT_dist.
+   */
+  struct concurrent_pT_dist : analyser {
+
+    /** \brief What the clones share.
+     */
+    struct shared_state {
+
+      concurrent_histogram hist;
+
+      /** \brief Number of clones made so far, it hands out the shards.
+       */
+      std::atomic<size_type> clones;
+
+      shared_state(const std::vector<value_type> & edges, size_type shards) :
+      hist  ("lepton pT distribution", edges, shards),
+      clones(0) {
+      }
+
+    }; // end of struct shared_state
+
+    /** \brief The shared histogram.
+     */
+    std::shared_ptr<shared_state> _M_shared;
+
+    /** \brief The shard filled by this analyser.
+     */
+    size_type _M_shard;
+
+    /** \brief Scratch space of analyze_batch().
+     */
+    std::vector<value_type> _M_pT;
+
+    /** \brief Construct with the number of worker shards and the binning of
+     * pT_dist.
+     */
+    explicit concurrent_pT_dist(size_type shards) :
+    _M_shared(std::make_shared<shared_state>(histogram::regular_bin_edges(0.0, 400, 20), shards)),
+    _M_shard (shards) {
+    }
+
+    concurrent_pT_dist(const concurrent_pT_dist &) = default;
+
+    virtual ~concurrent_pT_dist() {
+    }
+
+    concurrent_pT_dist & operator = (const concurrent_pT_dist &) = default;
+
+    /** \brief Analyze an event.
+     */
+    void analyze(const event & p, value_type weight) {
+      _M_fill(p.pT(1), weight);
+    }
+
+    /** \brief Analyze a block of events, first the pT of the whole block,
+     * then the fills.
+     */
+    void analyze_batch(const event * ev, const value_type * weights, size_type n) {
+
+      if (_M_pT.size() < n) { _M_pT.resize(n); }
+
+      for (size_type i = 0; i < n; i++) {
+        const lorentzvector & q = ev[i][1].momentum;
+        _M_pT[i] = std::sqrt(q.X()*q.X() + q.Y()*q.Y());
+      }
+
+      for (size_type i = 0; i < n; i++) {
+        _M_fill(_M_pT[i], weights[i]);
+      }
+    }
+
+    /** \brief A new analyser filling the next shard of the same histogram.
+     */
+    concurrent_pT_dist * clone() const {
+      concurrent_pT_dist * res = new concurrent_pT_dist(*this);
+      res->_M_shard = _M_shared->clones.fetch_add(1, std::memory_order_relaxed);
+      res->_M_number_of_events = 0;
+      return res;
+    }
+
+    /** \brief Nothing to add, the clones fill the same histogram, only the
+     * event counters are merged.
+     */
+    void merge_results(const analyser &) {
+    }
+
+    /** \brief Print the result, the same as pT_dist.
+     */
+    std::ostream & print(std::ostream & os) const {
+      return _M_shared->hist.snapshot().print(os, _M_number_of_events);
+    }
+
+  private:
+
+    void _M_fill(value_type pT, value_type weight) {
+      if (_M_shard < _M_shared->hist.number_of_shards()) {
+        _M_shared->hist.accumulate(_M_shard, pT, weight);
+      } else {
+        _M_shared->hist.accumulate_atomic(pT, weight);
+      }
+    }
+
+  }; // end of struct concurrent_pT_dist
+
+} // end of namespace school
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * \file
+ * \brief Implementation of kinematic_cuts members.
+ */
+
+#include "cuts.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace school {
+
+  // Charged leptons and neutrinos have |flavor| 11..16.
+  static inline bool __is_lepton(flavor_type f) {
+    int a = std::abs(static_cast<int>(f));
+    return a >= 11 && a <= 16;
+  }
+
+  bool kinematic_cuts::operator () (const event & ev) const {
+
+    event::index_type n = static_cast<event::index_type>(ev.number_of_outgoings());
+
+    //----- invariant mass of the leptons from the dot products -----
+    value_type m2 = 0.0;
+
+    for (event::index_type i = 1; i <= n; i++) {
+      if (!__is_lepton(ev[i].flavor)) { continue; }
+      for (event::index_type j = 1; j <= n; j++) {
+        if (__is_lepton(ev[j].flavor)) { m2 += ev.dot(i,j); }
+      }
+    }
+
+    if (m2 < m_min*m_min || m2 > m_max*m_max) { return false; }
+
+    //----- single lepton cuts -----
+    for (event::index_type i = 1; i <= n; i++) {
+      if (!__is_lepton(ev[i].flavor)) { continue; }
+
+      value_type pT = ev.pT(i);
+      if (pT < pT_min || pT > pT_max) { return false; }
+
+      if (y_max < std::numeric_limits<value_type>::infinity() && std::abs(ev.rapidity(i)) > y_max) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+} // end of namespace school
+
+std::ostream & operator << (std::ostream & os, const school::kinematic_cuts & c) {
+  return os
+    << c.pT_min << " < pT < " << c.pT_max << ", "
+    << "|y| < "  << c.y_max   << ", "
+    << c.m_min  << " < m < "  << c.m_max;
+}
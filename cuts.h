@@ -0,0 +1,56 @@
+/**
+ * \file
+ * \brief Definition of the kinematic_cuts class.
+ */
+
+#ifndef __SCHOOL_CUTS_H__
+#define __SCHOOL_CUTS_H__ 1
+
+#include "event.h"
+
+#include <iostream>
+#include <limits>
+
+namespace school {
+
+  /** \brief Kinematic cuts on the outgoing leptons.
+   *
+   * Every outgoing lepton must have pT_min < pT < pT_max and |y| < y_max,
+   * and the invariant mass of all outgoing leptons together must be in
+   * [m_min, m_max]. The default constructor sets the windows wide open. The
+   * cuts use the invariant tables of the event, so the work is shared with
+   * the matrix element and the analysers.
+   */
+  struct kinematic_cuts {
+
+    typedef event::value_type value_type;
+
+    value_type pT_min; ///< Lower bound of the lepton pT
+    value_type pT_max; ///< Upper bound of the lepton pT
+    value_type y_max;  ///< Upper bound of the absolute lepton rapidity
+    value_type m_min;  ///< Lower bound of the invariant mass of the leptons
+    value_type m_max;  ///< Upper bound of the invariant mass of the leptons
+
+    /** \brief The default constructor switches every cut off.
+     */
+    kinematic_cuts() :
+    pT_min(0.0),
+    pT_max(std::numeric_limits<value_type>::infinity()),
+    y_max (std::numeric_limits<value_type>::infinity()),
+    m_min (0.0),
+    m_max (std::numeric_limits<value_type>::infinity()) {
+    }
+
+    /** \brief True if the event passes the cuts.
+     */
+    bool operator () (const event &) const;
+
+  }; // end of struct kinematic_cuts
+
+} // end of namespace school
+
+// I/O operators defined in the global namespace
+
+std::ostream & operator << (std::ostream &, const school::kinematic_cuts &);
+
+#endif
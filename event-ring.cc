@@ -0,0 +1,30 @@
+/**
+ * \file
+ * \brief Implementation of event_ring members.
+ */
+
+#include "event-ring.h"
+
+namespace school {
+
+  // Smallest power of 2 not less than n.
+  static event_ring::size_type __ring_size(event_ring::size_type n) {
+    event_ring::size_type size = 1;
+    while (size < n) { size *= 2; }
+    return size;
+  }
+
+  event_ring::event_ring(size_type capacity, size_type n) :
+  _M_slots(__ring_size(capacity)),
+  _M_mask (_M_slots.size() - 1),
+  _M_write(0),
+  _M_read (0) {
+
+    for (size_type k = 0; k < _M_slots.size(); k++) {
+      _M_slots[k].sequence.store(k, std::memory_order_relaxed);
+      _M_slots[k].ev.resize(n);
+      _M_slots[k].weight = 0.0;
+    }
+  }
+
+} // end of namespace school
@@ -0,0 +1,147 @@
+/**
+ * \file
+ * \brief Definition of the event_ring class.
+ */
+
+#ifndef __SCHOOL_EVENT_RING_H__
+#define __SCHOOL_EVENT_RING_H__ 1
+
+#include "event.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace school {
+
+  /** \brief Bounded lock-free ring buffer of preallocated events.
+   *
+   * Any number of producers and consumers can use the ring at the same time.
+   * A producer claims the next slot with acquire_write(), fills the event in
+   * place and hands it over with publish(). A consumer claims the next filled
+   * slot with acquire_read(), works on the event in place and gives the slot
+   * back with release(). Every slot carries a sequence number which tells
+   * whose turn it is, so the only shared writes are one fetch_add per claim
+   * and one store per hand-over. The events are reused, nothing is allocated
+   * after the construction. If the ring is full the producers wait, if it is
+   * empty the consumers wait (spinning with yield).
+   */
+  class event_ring {
+
+  public:
+
+    typedef event::size_type  size_type;
+    typedef event::value_type value_type;
+
+    /** \brief A slot of the ring.
+     *
+     * The padding keeps the sequence numbers and events of neighbouring
+     * slots on separate cache lines, whatever the alignment of the ring.
+     */
+    struct slot {
+      std::atomic<size_type> sequence;
+      event                  ev;
+      value_type             weight;
+      char                   pad[64];
+    };
+
+  private:
+
+    std::vector<slot> _M_slots;
+    size_type         _M_mask;
+
+    // The claim counters are on separate cache lines.
+    char                   _M_pad0[64];
+    std::atomic<size_type> _M_write;
+    char                   _M_pad1[64];
+    std::atomic<size_type> _M_read;
+    char                   _M_pad2[64];
+
+  public:
+
+    /** \brief Make a ring with the capacity rounded up to a power of 2.
+     *
+     * The events are prepared with n outgoing particles.
+     */
+    explicit event_ring(size_type capacity, size_type n = 2);
+
+    event_ring(const event_ring &)               = delete;
+    event_ring & operator = (const event_ring &) = delete;
+
+    /** \brief Number of slots.
+     */
+    size_type capacity() const {
+      return _M_slots.size();
+    }
+
+    /** \brief Number of read tickets handed out so far.
+     */
+    size_type tickets_read() const {
+      return _M_read.load(std::memory_order_relaxed);
+    }
+
+    /** \brief The slot of a ticket.
+     */
+    slot & operator [] (size_type ticket) {
+      return _M_slots[ticket & _M_mask];
+    }
+
+    /** \brief Claim the next free slot, returns its ticket.
+     */
+    size_type acquire_write() {
+      size_type ticket = _M_write.fetch_add(1, std::memory_order_relaxed);
+      _M_wait((*this)[ticket], ticket);
+      return ticket;
+    }
+
+    /** \brief Hand a filled slot over to the consumers.
+     */
+    void publish(size_type ticket) {
+      (*this)[ticket].sequence.store(ticket + 1, std::memory_order_release);
+    }
+
+    /** \brief Claim the next slot to read, returns its ticket.
+     *
+     * Tickets are handed out in order. The caller must know how many events
+     * will be published and must not claim more, otherwise it waits forever.
+     * Use try_acquire_read() for that.
+     */
+    size_type acquire_read() {
+      size_type ticket = _M_read.fetch_add(1, std::memory_order_relaxed);
+      _M_wait((*this)[ticket], ticket + 1);
+      return ticket;
+    }
+
+    /** \brief Claim the next slot to read, if there are less than limit
+     * tickets handed out so far.
+     */
+    bool try_acquire_read(size_type limit, size_type & ticket) {
+      ticket = _M_read.load(std::memory_order_relaxed);
+      do {
+        if (ticket >= limit) { return false; }
+      } while (!_M_read.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed));
+      _M_wait((*this)[ticket], ticket + 1);
+      return true;
+    }
+
+    /** \brief Give a slot back to the producers.
+     */
+    void release(size_type ticket) {
+      (*this)[ticket].sequence.store(ticket + _M_slots.size(), std::memory_order_release);
+    }
+
+  private:
+
+    /** \brief Wait until the slot gets the expected sequence number.
+     */
+    static void _M_wait(const slot & s, size_type expected) {
+      while (s.sequence.load(std::memory_order_acquire) != expected) {
+        std::this_thread::yield();
+      }
+    }
+
+  }; // end of class event_ring
+
+} // end of namespace school
+
+#endif
@@ -7,23 +7,59 @@
 #include "school-rng.h"
 #include "rambo.h"
 
+// Standard includes
+#include <limits>
+
 namespace school {
 
-  event::value_type generate_event(event & p, event::value_type Ecm) {
+  void event::_M_fill_dots() const {
 
-    // By default it will result random numbers in the range [0,1)
-    std::uniform_real_distribution<event::value_type> rng;
+    size_type n = _M_array.size();
 
-    //----- generating the momentum fraction of the incoming parton -----
-    p.xa = rng(_G_random_engine);
-    p.xb = rng(_G_random_engine);
+    for (size_type i = 0; i < n; i++) {
+      for (size_type j = i; j < n; j++) {
+        _M_dots[i*n+j] = _M_dots[j*n+i] = _M_array[i].momentum * _M_array[j].momentum;
+      }
+    }
 
-    //----- incoming parton -----
+    _M_dots_valid = true;
+  }
+
+  void event::_M_fill_pT() const {
+
+    size_type n = _M_array.size();
+
+    for (size_type i = 0; i < n; i++) {
+      _M_pT[i] = _M_array[i].momentum.perp();
+    }
+
+    _M_pT_valid = true;
+  }
+
+  void event::_M_fill_rapidity() const {
+
+    size_type n = _M_array.size();
+
+    // The incoming partons are along the beam, their rapidity is infinite.
+    _M_rapidity[0] = -std::numeric_limits<value_type>::infinity();
+    _M_rapidity[1] =  std::numeric_limits<value_type>::infinity();
+
+    for (size_type i = 2; i < n; i++) {
+      _M_rapidity[i] = _M_array[i].momentum.rapidity();
+    }
+
+    _M_rapidity_valid = true;
+  }
+
+  // Incoming partons from the momentum fractions, the outgoings are in the
+  // partonic c.m. frame.
+  static void __generate_event_incoming(event & p, event::value_type Ecm) {
     p[-1].momentum = 0.5*p.xa*lorentzvector(0.0, 0.0, -Ecm, Ecm);
     p[ 0].momentum = 0.5*p.xb*lorentzvector(0.0, 0.0,  Ecm, Ecm);
+  }
 
-    //----- generates the outgoings in partonic c.m. frame -----
-    event::value_type weight = rambo(p.xa*p.xb*Ecm*Ecm, p.begin()+2, p.end());
+  // Boost the outgoings to the laboratory frame and add the flux factor.
+  static event::value_type __generate_event_finish(event & p, event::value_type Ecm, event::value_type weight) {
 
     //----- boost to laboratory frame -----
     event::value_type bz = (p.xb-p.xa)/(p.xa+p.xb);
@@ -38,6 +74,36 @@ namespace school {
     return weight;
   }
 
+  event::value_type generate_event(event & p, event::value_type Ecm) {
+
+    // By default it will result random numbers in the range [0,1)
+    std::uniform_real_distribution<event::value_type> rng;
+
+    //----- generating the momentum fraction of the incoming parton -----
+    p.xa = rng(_G_random_engine);
+    p.xb = rng(_G_random_engine);
+
+    //----- incoming parton -----
+    __generate_event_incoming(p, Ecm);
+
+    //----- generates the outgoings in partonic c.m. frame -----
+    event::value_type weight = rambo(p.xa*p.xb*Ecm*Ecm, p.begin()+2, p.end());
+
+    return __generate_event_finish(p, Ecm, weight);
+  }
+
+  event::value_type generate_event(event & p, event::value_type Ecm, const event::value_type * u) {
+
+    p.xa = u[0];
+    p.xb = u[1];
+
+    __generate_event_incoming(p, Ecm);
+
+    event::value_type weight = rambo(p.xa*p.xb*Ecm*Ecm, p.begin()+2, p.end(), u+2);
+
+    return __generate_event_finish(p, Ecm, weight);
+  }
+
 } // end of namespace school
 
 std::ostream & operator << (std::ostream & os, const school::event & a) {
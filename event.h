@@ -65,16 +65,38 @@ namespace school {
     /** This will store the 2 incoming and n outgoing particles. */
     std::vector<particle> _M_array;
 
+    /** Pairwise dot products p_i*p_j, (n+2)x(n+2), filled on first use. */
+    mutable std::vector<value_type> _M_dots;
+
+    /** Transverse momenta and rapidities, each filled on first use. */
+    mutable std::vector<value_type> _M_pT, _M_rapidity;
+
+    /** Validity flags of the invariant tables. */
+    mutable bool _M_dots_valid, _M_pT_valid, _M_rapidity_valid;
+
+    /** Whether the invariants are cached or calculated at every query. */
+    bool _M_cache_invariants;
+
   public:
 
     /** Construct an event with n outgoing particles. */
-    explicit event(size_type n = 1) : _M_array(n+2) {
+    explicit event(size_type n = 1) :
+    _M_array(n+2),
+    _M_dots_valid(false),
+    _M_pT_valid(false),
+    _M_rapidity_valid(false),
+    _M_cache_invariants(true) {
+      _M_size_invariants();
     }
 
     // Copy
     event(const event &)               = default;
     event & operator = (const event &) = default;
 
+    // Move (std::swap of events only swaps the buffers)
+    event(event &&)               = default;
+    event & operator = (event &&) = default;
+
     // Dectructor
     ~event() = default;
 
@@ -85,6 +107,7 @@ namespace school {
      * Outgoing particles are indexed from 1 to n.
      */
     particle & operator [] (index_type k) {
+      invalidate_invariants();
       return _M_array[static_cast<size_type>(k+1)];
     }
 
@@ -99,6 +122,7 @@ namespace school {
     }
 
     iterator begin() {
+      invalidate_invariants();
       return _M_array.begin();
     }
 
@@ -107,6 +131,7 @@ namespace school {
     }
 
     iterator end() {
+      invalidate_invariants();
       return _M_array.end();
     }
 
@@ -116,7 +141,9 @@ namespace school {
 
     /** Resize event to contain n outgoing particles. */
     void resize(size_type n) {
+      invalidate_invariants();
       _M_array.resize(n+2);
+      _M_size_invariants();
     }
 
     /** Query the number of outgoing particles. */
@@ -124,11 +151,92 @@ namespace school {
       return _M_array.size()-2;
     }
 
+    // Lorentz invariants and simple kinematics.
+    //
+    // With caching on (the default) every table is calculated for all
+    // particles at its first query after the momenta have changed and is
+    // shared by everybody who looks at the event (matrix element, cuts,
+    // analysers). Every non-const access (element access, iterators, resize)
+    // invalidates them, so read the flavors through a const event when the
+    // momenta stay. If momenta are modified through an iterator that was
+    // taken before a query, call invalidate_invariants() by hand. With
+    // caching off every query is calculated from the momenta.
+
+    /** Switch the caching of the invariants on or off. */
+    void cache_invariants(bool on) {
+      _M_cache_invariants = on;
+      invalidate_invariants();
+    }
+
+    /** Query whether the invariants are cached. */
+    bool caches_invariants() const {
+      return _M_cache_invariants;
+    }
+
+    /** Dot product p_i*p_j. */
+    value_type dot(index_type i, index_type j) const {
+      if (!_M_cache_invariants) { return (*this)[i].momentum * (*this)[j].momentum; }
+      if (!_M_dots_valid) { _M_fill_dots(); }
+      return _M_dots[static_cast<size_type>((i+1)*static_cast<index_type>(_M_array.size()) + j+1)];
+    }
+
+    /** Invariant mass squared s_ij = (p_i+p_j)^2. */
+    value_type s(index_type i, index_type j) const {
+      return dot(i,i) + dot(j,j) + 2.0*dot(i,j);
+    }
+
+    /** Transverse momentum of particle k. */
+    value_type pT(index_type k) const {
+      if (!_M_cache_invariants) { return (*this)[k].momentum.perp(); }
+      if (!_M_pT_valid) { _M_fill_pT(); }
+      return _M_pT[static_cast<size_type>(k+1)];
+    }
+
+    /** Rapidity of particle k. */
+    value_type rapidity(index_type k) const {
+      if (!_M_cache_invariants) { return (*this)[k].momentum.rapidity(); }
+      if (!_M_rapidity_valid) { _M_fill_rapidity(); }
+      return _M_rapidity[static_cast<size_type>(k+1)];
+    }
+
+    /** Mark the invariant tables outdated. */
+    void invalidate_invariants() {
+      _M_dots_valid     = false;
+      _M_pT_valid       = false;
+      _M_rapidity_valid = false;
+    }
+
+  private:
+
+    // The invariant tables get their size with the particles, so filling
+    // them in the event loop never allocates.
+    void _M_size_invariants() {
+      size_type n = _M_array.size();
+      _M_dots    .resize(n*n);
+      _M_pT      .resize(n);
+      _M_rapidity.resize(n);
+    }
+
+    // These are defined in event.cc.
+    void _M_fill_dots() const;
+    void _M_fill_pT() const;
+    void _M_fill_rapidity() const;
+
   }; // end of class event
 
   /** Generate the hadronic event. */
   event::value_type generate_event(event &, event::value_type);
 
+  /** Generate the hadronic event from the uniform random numbers in u, xa
+   *  and xb first, then 4 for every outgoing particle.
+   */
+  event::value_type generate_event(event &, event::value_type, const event::value_type * u);
+
+  /** Number of uniform random numbers generate_event() takes for n outgoings. */
+  inline event::size_type generate_event_dimension(event::size_type n) {
+    return 2 + 4*n;
+  }
+
 } // end of namespace school
 
 // I/O operators defined in the global namespace
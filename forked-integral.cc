@@ -0,0 +1,176 @@
+/**
+ * \file
+ * \brief Implementation of forked_integral members.
+ */
+
+#include "forked-integral.h"
+#include "school-rng.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace school {
+
+  // Number of shared memory segments made by this process, it makes their
+  // names unique among concurrent calls.
+  static std::atomic<unsigned long> __forked_integral_segments(0);
+
+  static void __forked_integral_error(const std::string & what) {
+    throw std::runtime_error("forked_integral: " + what + ": " + std::strerror(errno));
+  }
+
+  // The work of child w, it never returns.
+  static void __forked_integral_child(
+    mc_integral                    & integral,
+    std::size_t                      n,
+    std::size_t                      w,
+    const std::vector<analyser*>   & prototypes,
+    unsigned long                    seed,
+    event::value_type              * slot
+  ) {
+    const std::size_t block_size = 1024;
+    const std::size_t rejected   = integral.number_of_rejected();
+
+    try {
+      std::vector<std::unique_ptr<analyser> > clones;
+      for (auto a : prototypes) {
+        clones.push_back(std::unique_ptr<analyser>(a->clone()));
+      }
+
+      std::vector<event>             events (block_size);
+      std::vector<event::value_type> weights(block_size);
+
+      seed_random_engine(seed, w);
+
+      for (std::size_t done = 0; done < n; ) {
+        std::size_t m = n - done < block_size ? n - done : block_size;
+        for (std::size_t k = 0; k < m; k++) {
+          weights[k] = integral.generate(events[k]);
+        }
+        for (auto & a : clones) {
+          a->operator()(events.data(), weights.data(), m);
+        }
+        done += m;
+      }
+
+      // slot: rejected events, then the analyser states
+      slot[0] = static_cast<event::value_type>(integral.number_of_rejected() - rejected);
+      event::value_type * out = slot + 1;
+      for (auto & a : clones) {
+        a->store_state(out);
+        out += a->state_size();
+      }
+    } catch (const std::exception & error) {
+      std::cerr << "worker " << w << ": " << error.what() << std::endl;
+      _exit(1);
+    }
+
+    _exit(0);
+  }
+
+  void forked_integral::operator () (
+    size_type                        n,
+    size_type                        workers,
+    const std::vector<analyser*> & ah,
+    unsigned long                    seed
+  ) {
+
+    if (workers == 0) { workers = 1; }
+
+    const std::vector<analyser*> prototypes(ah);
+
+    // size of a slot: the rejected events and the analyser states
+    size_type slot_size = 1;
+    for (auto a : prototypes) {
+      slot_size += a->state_size();
+    }
+
+    //----- shared memory, unlinked at once, the mapping is inherited -----
+    std::ostringstream name;
+    name << "/school-forked-integral-" << getpid() << "-" << __forked_integral_segments++;
+
+    int fd = shm_open(name.str().c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) { __forked_integral_error("shm_open"); }
+    shm_unlink(name.str().c_str());
+
+    const size_type bytes = workers*slot_size*sizeof(value_type);
+
+    if (ftruncate(fd, bytes) != 0) {
+      close(fd);
+      __forked_integral_error("ftruncate");
+    }
+
+    void * memory = mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) { __forked_integral_error("mmap"); }
+
+    value_type * slots = static_cast<value_type *>(memory);
+
+    //----- fork the workers -----
+    // flush first, otherwise the children inherit unwritten output
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(0);
+
+    std::vector<pid_t> children;
+
+    for (size_type w = 0; w < workers; w++) {
+      pid_t pid = fork();
+      if (pid < 0) {
+        for (auto c : children) { waitpid(c, 0, 0); }
+        munmap(memory, bytes);
+        __forked_integral_error("fork");
+      }
+      if (pid == 0) {
+        __forked_integral_child(_M_integral, (w+1)*n/workers - w*n/workers, w, prototypes, seed, slots + w*slot_size);
+      }
+      children.push_back(pid);
+    }
+
+    //----- wait for them -----
+    size_type failed = 0;
+
+    for (auto c : children) {
+      int   status = 0;
+      pid_t res;
+      while ((res = waitpid(c, &status, 0)) < 0 && errno == EINTR) {}
+      if (res < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) { ++failed; }
+    }
+
+    if (failed) {
+      munmap(memory, bytes);
+      std::ostringstream what;
+      what << "forked_integral: " << failed << " of " << workers << " workers failed";
+      throw std::runtime_error(what.str());
+    }
+
+    //----- merge in worker order -----
+    _M_number_of_rejected = 0;
+
+    for (size_type w = 0; w < workers; w++) {
+      const value_type * in = slots + w*slot_size;
+      _M_number_of_rejected += static_cast<size_type>(in[0]);
+      in += 1;
+      for (auto a : prototypes) {
+        a->add_state(in);
+        in += a->state_size();
+      }
+    }
+
+    munmap(memory, bytes);
+  }
+
+} // end of namespace school
@@ -0,0 +1,78 @@
+/**
+ * \file
+ * \brief Definition of the forked_integral class.
+ */
+
+#ifndef __SCHOOL_FORKED_INTEGRAL_H__
+#define __SCHOOL_FORKED_INTEGRAL_H__ 1
+
+#include "mc-integral.h"
+
+#include <vector>
+
+namespace school {
+
+  /** \brief MC integral running in several processes.
+   *
+   * For pdfs and matrix elements which are not thread safe. The calling
+   * process forks one child per worker, and every child works on its own
+   * copy of everything, so nothing has to be reentrant. Child w generates its
+   * share of the events with the random stream seed_random_engine(seed, w)
+   * into clones of the analysers, then writes the analyser states
+   * (analyser::store_state()) into its slot of a POSIX shared memory
+   * segment. The parent waits for the children and adds the slots to the
+   * given analysers in worker order.
+   *
+   * Failures (shared memory, fork, a child that did not finish) are reported
+   * with std::runtime_error. An analyser which cannot be serialized throws
+   * its std::logic_error from state_size() before anything is forked.
+   */
+  class forked_integral {
+
+  public:
+
+    typedef event::value_type value_type;
+    typedef event::size_type  size_type;
+
+  private:
+
+    /** \brief The integral, the children get a copy with the fork.
+     */
+    mc_integral _M_integral;
+
+    size_type _M_number_of_rejected;
+
+  public:
+
+    forked_integral(
+      value_type             Ecm ,
+      const qcd_hadron_base *pdf1,
+      const qcd_hadron_base *pdf2,
+      const matrix_element  *me  ,
+      const kinematic_cuts  *cuts = 0
+    ) :
+    _M_integral          (Ecm, pdf1, pdf2, me, cuts),
+    _M_number_of_rejected(0) {
+    }
+
+    /** \brief Generate n events in the given number of processes and
+     * analyse them.
+     */
+    void operator () (
+      size_type                        n,
+      size_type                        workers,
+      const std::vector<analyser*> & ah,
+      unsigned long                    seed = 0
+    );
+
+    /** \brief Number of events rejected by the cuts in the last run.
+     */
+    size_type number_of_rejected() const {
+      return _M_number_of_rejected;
+    }
+
+  }; // end of class forked_integral
+
+} // end of namespace school
+
+#endif
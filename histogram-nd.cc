@@ -0,0 +1,60 @@
+/**
+ * \file
+ * \brief Implementation of axis and histogram_nd class methods.
+ */
+
+#include "histogram-nd.h"
+
+namespace school {
+
+  axis::value_type axis::lower(size_type k) const {
+    switch (_M_kind) {
+      case regular_kind:
+        return _M_lower + k/_M_scale;
+      case log_kind:
+        return std::exp(_M_lower + k/_M_scale);
+      default:
+        return _M_edges[k];
+    }
+  }
+
+  histogram_nd::histogram_nd(const std::string & name, const std::vector<axis> & axes) :
+  _M_name(name),
+  _M_axes(axes) {
+
+    size_type n = 1;
+
+    for (auto & a : _M_axes) {
+      _M_strides.push_back(n);
+      n *= a.size();
+    }
+
+    _M_bins.resize(n);
+  }
+
+  std::ostream & histogram_nd::print(std::ostream & os, unsigned long npoints) const {
+
+    // print the name
+    os << "#   " << _M_name << std::endl;
+
+    // print the bins
+    for (size_type n = 0; n < _M_bins.size(); n++) {
+
+      const bin & b = _M_bins[n];
+      value_type  dx = 1.0;
+
+      for (size_type d = 0; d < _M_axes.size(); d++) {
+        size_type k = n / _M_strides[d] % _M_axes[d].size();
+        os << _M_axes[d].lower(k) << "  " << _M_axes[d].upper(k) << "  ";
+        dx *= _M_axes[d].upper(k) - _M_axes[d].lower(k);
+      }
+
+      os << b.sum_of_weights/npoints/dx << "  "
+         << std::sqrt((b.sum_of_squared_weights - b.sum_of_weights * b.sum_of_weights / npoints) / npoints) / dx
+         << std::endl;
+    }
+
+    return os;
+  }
+
+} // end of namespace school
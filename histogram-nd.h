@@ -0,0 +1,242 @@
+/**
+ * \file
+ * \brief Definition of the axis and histogram_nd classes.
+ */
+
+#ifndef __SCHOOL_HISTOGRAM_ND_H__
+#define __SCHOOL_HISTOGRAM_ND_H__ 1
+
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace school {
+
+  /** \brief Binning of one histogram axis.
+   *
+   * Regular and logarithmic axes find the bin with one multiplication, only
+   * axes with arbitrary edges need a binary search. Bins are [lower, upper).
+   */
+  class axis {
+
+  public:
+
+    typedef histogram::size_type  size_type;
+    typedef histogram::value_type value_type;
+
+    /** \brief The kind of binning. */
+    enum kind_type { regular_kind, log_kind, variable_kind };
+
+  private:
+
+    kind_type  _M_kind;
+    size_type  _M_n;     ///< number of bins
+    value_type _M_lower; ///< lower edge (its log for log axes)
+    value_type _M_scale; ///< bins per unit (per unit of log for log axes)
+
+    /** \brief Edges, only for variable_kind.
+     */
+    std::vector<value_type> _M_edges;
+
+    axis(kind_type kind, size_type n, value_type lower, value_type scale) :
+    _M_kind (kind ),
+    _M_n    (n    ),
+    _M_lower(lower),
+    _M_scale(scale) {
+    }
+
+  public:
+
+    /** \brief n bins of equal width between lower and upper.
+     */
+    static axis regular(value_type lower, value_type upper, size_type n) {
+      return axis(regular_kind, n, lower, n/(upper - lower));
+    }
+
+    /** \brief n bins of equal logarithmic width between lower and upper.
+     */
+    static axis logarithmic(value_type lower, value_type upper, size_type n) {
+      return axis(log_kind, n, std::log(lower), n/std::log(upper/lower));
+    }
+
+    /** \brief Bins with arbitrary edges.
+     */
+    static axis variable(const std::vector<value_type> & edges) {
+      axis res(variable_kind, edges.size()-1, edges.front(), 0.0);
+      res._M_edges = edges;
+      return res;
+    }
+
+    /** \brief Number of bins.
+     */
+    size_type size() const {
+      return _M_n;
+    }
+
+    /** \brief Find the bin of x, false if x is outside of the axis.
+     */
+    bool index(value_type x, size_type & k) const {
+      value_type t;
+
+      switch (_M_kind) {
+        case regular_kind:
+          t = (x - _M_lower)*_M_scale;
+          break;
+        case log_kind:
+          if (!(x > 0.0)) { return false; }
+          t = (std::log(x) - _M_lower)*_M_scale;
+          break;
+        default:
+          if (!(x >= _M_edges.front() && x < _M_edges.back())) { return false; }
+          k = static_cast<size_type>(std::upper_bound(_M_edges.begin(), _M_edges.end(), x) - _M_edges.begin()) - 1;
+          return true;
+      }
+
+      if (!(t >= 0.0 && t < _M_n)) { return false; }
+      k = static_cast<size_type>(t);
+      return true;
+    }
+
+    /** \brief Lower edge of bin k.
+     */
+    value_type lower(size_type k) const;
+
+    /** \brief Upper edge of bin k.
+     */
+    value_type upper(size_type k) const {
+      return lower(k+1);
+    }
+
+  }; // end of class axis
+
+  /** \brief Histogram in any number of dimensions.
+   *
+   * The bins are kept in one contiguous array, the first axis runs fastest.
+   * Every bin has the same statistics as a histogram bin, and print() writes
+   * one line per bin with the edges of every axis, the value and the error.
+   */
+  class histogram_nd {
+
+  public:
+
+    typedef histogram::size_type  size_type;
+    typedef histogram::value_type value_type;
+    typedef histogram::bin        bin;
+
+  private:
+
+    /** \brief Name of the analysis.
+     */
+    std::string _M_name;
+
+    /** \brief The axes.
+     */
+    std::vector<axis> _M_axes;
+
+    /** \brief Distance of neighbouring bins along each axis.
+     */
+    std::vector<size_type> _M_strides;
+
+    /** \brief Content of the histogram.
+     */
+    std::vector<bin> _M_bins;
+
+  public:
+
+    /** There is no analysis without a name and a binning. */
+    histogram_nd() = delete;
+
+    histogram_nd(const histogram_nd &)               = default;
+    ~histogram_nd()                                  = default;
+    histogram_nd & operator = (const histogram_nd &) = default;
+
+    /** Construct giving name and axes. */
+    histogram_nd(const std::string & name, const std::vector<axis> & axes);
+
+    /** \brief Number of dimensions.
+     */
+    size_type dimension() const {
+      return _M_axes.size();
+    }
+
+    /** \brief Accumulate weights, x has one observable per axis.
+     */
+    void accumulate(const value_type * x, value_type weight) {
+      size_type n = 0, k;
+      for (size_type d = 0; d < _M_axes.size(); d++) {
+        if (!_M_axes[d].index(x[d], k)) { return; }
+        n += k*_M_strides[d];
+      }
+      _M_bins[n].count(weight);
+    }
+
+    /** \brief Accumulate weights into a 2-dimensional histogram.
+     */
+    void accumulate(value_type x, value_type y, value_type weight) {
+      size_type kx, ky;
+      if (!_M_axes[0].index(x, kx) || !_M_axes[1].index(y, ky)) { return; }
+      _M_bins[kx + ky*_M_strides[1]].count(weight);
+    }
+
+    /** \brief Accumulate weights into a 3-dimensional histogram.
+     */
+    void accumulate(value_type x, value_type y, value_type z, value_type weight) {
+      size_type kx, ky, kz;
+      if (!_M_axes[0].index(x, kx) || !_M_axes[1].index(y, ky) || !_M_axes[2].index(z, kz)) { return; }
+      _M_bins[kx + ky*_M_strides[1] + kz*_M_strides[2]].count(weight);
+    }
+
+    /** \brief Add the content of a histogram with the same axes.
+     */
+    void add(const histogram_nd & h) {
+      for (size_type n = 0; n < _M_bins.size() && n < h._M_bins.size(); n++) {
+        _M_bins[n] += h._M_bins[n];
+      }
+    }
+
+    /** \brief Set every bin to zero.
+     */
+    void clear() {
+      for (auto & b : _M_bins) {
+        b = bin();
+      }
+    }
+
+    /** \brief Number of doubles written by store_state().
+     */
+    size_type state_size() const {
+      return 2*_M_bins.size();
+    }
+
+    /** \brief Write the bin contents as a flat array of doubles.
+     */
+    void store_state(value_type * out) const {
+      for (auto & b : _M_bins) {
+        *out++ = b.sum_of_weights;
+        *out++ = b.sum_of_squared_weights;
+      }
+    }
+
+    /** \brief Add bin contents written by store_state() of a histogram with
+     * the same axes.
+     */
+    void add_state(const value_type * in) {
+      for (auto & b : _M_bins) {
+        b.sum_of_weights         += *in++;
+        b.sum_of_squared_weights += *in++;
+      }
+    }
+
+    /** \brief Print histogram.
+     */
+    std::ostream & print(std::ostream &, unsigned long) const;
+
+  }; // end of class histogram_nd
+
+} // end of namespace school
+
+#endif
@@ -46,6 +46,14 @@ namespace school {
         sum_of_weights         += weight;
         sum_of_squared_weights += weight*weight;
       }
+
+      /** \brief Add the content of another bin.
+       */
+      bin & operator += (const bin & b) {
+        sum_of_weights         += b.sum_of_weights;
+        sum_of_squared_weights += b.sum_of_squared_weights;
+        return *this;
+      }
     }; // end of struct bin
 
   private:
@@ -99,6 +107,70 @@ namespace school {
       b->second.count(weight);
     }
 
+    /** \brief Name of the histogram.
+     */
+    const std::string & name() const {
+      return _M_name;
+    }
+
+    /** \brief Number of bins.
+     */
+    size_type size() const {
+      return _M_bins.size();
+    }
+
+    /** \brief Add bin contents, one for every bin in increasing order.
+     */
+    void add(const std::vector<bin> & bins) {
+      auto b = bins.begin();
+      for (auto p = _M_bins.begin(); p != _M_bins.end() && b != bins.end(); ++p, ++b) {
+        p->second += *b;
+      }
+    }
+
+    /** \brief Add the content of a histogram with the same binning.
+     */
+    void add(const histogram & h) {
+      auto b = h._M_bins.begin();
+      for (auto p = _M_bins.begin(); p != _M_bins.end() && b != h._M_bins.end(); ++p, ++b) {
+        p->second += b->second;
+      }
+    }
+
+    /** \brief Set every bin to zero.
+     */
+    void clear() {
+      for (auto & p : _M_bins) {
+        p.second = bin();
+      }
+    }
+
+    /** \brief Number of doubles written by store_state().
+     */
+    size_type state_size() const {
+      return 2*_M_bins.size();
+    }
+
+    /** \brief Write the bin contents as a flat array of doubles, sum of
+     * weights and sum of squared weights for every bin.
+     */
+    void store_state(value_type * out) const {
+      for (auto & p : _M_bins) {
+        *out++ = p.second.sum_of_weights;
+        *out++ = p.second.sum_of_squared_weights;
+      }
+    }
+
+    /** \brief Add bin contents written by store_state() of a histogram with
+     * the same binning.
+     */
+    void add_state(const value_type * in) {
+      for (auto & p : _M_bins) {
+        p.second.sum_of_weights         += *in++;
+        p.second.sum_of_squared_weights += *in++;
+      }
+    }
+
     /** \brief Print histogram.
      */
     std::ostream & print(std::ostream &, unsigned long) const;
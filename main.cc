@@ -2,34 +2,364 @@
 
 #include "mc-integral.h"
 #include "me-pp-to-llbar.h"
+#include "pipeline.h"
+#include "block-integral.h"
+#include "parallel-integral.h"
+#include "forked-integral.h"
+#include "perf-counters.h"
+#include "alloc-counter.h"
+#include "weight-monitor.h"
+#include "progress-monitor.h"
+#include "qmc-integral.h"
+#include "miser-integral.h"
+#include "concurrent-pT-dist.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace school;
 using namespace std;
 
-int main()
+// Reads the value of a "--name=value" command line option.
+static bool option(const char * arg, const char * name, double & value) {
+  size_t n = strlen(name);
+  if (strncmp(arg, "--", 2) != 0 || strncmp(arg+2, name, n) != 0 || arg[n+2] != '=') {
+    return false;
+  }
+  value = strtod(arg+n+3, 0);
+  return true;
+}
+
+// Reads the text of a "--name=text" command line option.
+static bool option(const char * arg, const char * name, string & value) {
+  size_t n = strlen(name);
+  if (strncmp(arg, "--", 2) != 0 || strncmp(arg+2, name, n) != 0 || arg[n+2] != '=') {
+    return false;
+  }
+  value = arg+n+3;
+  return true;
+}
+
+// Counts the heap allocations of the event loops, after a warm-up which
+// fills the buffers and caches. Returns 1 if any loop allocates in the
+// steady state.
+static int check_allocations(
+  mc_integral    & xsec,
+  block_integral & bxsec,
+  unsigned long              n,
+  const vector<analyser *> & analysers
+) {
+  if (!counting_allocations()) {
+    cerr << "allocation counting is off, build with DEFS=-DSCHOOL_COUNT_ALLOCATIONS" << endl;
+    return 2;
+  }
+
+  const unsigned long bs = 1024;
+  vector<event>       evs(bs);
+  vector<double>      w  (bs);
+  allocation_counts   scalar, generation, analysis, block, start;
+
+  for (int pass = 0; pass < 2; pass++) {  // the first pass is the warm-up
+    unsigned long m = pass ? n : bs;
+
+    start = current_allocation_counts();
+    for (unsigned long k = 0; k < m; k++) {
+      xsec(analysers);
+    }
+    scalar = current_allocation_counts() - start;
+
+    for (unsigned long done = 0; done < m; done += bs) {
+      start = current_allocation_counts();
+      for (unsigned long k = 0; k < bs; k++) {
+        w[k] = xsec.generate(evs[k]);
+      }
+      generation = generation + (current_allocation_counts() - start);
+
+      start = current_allocation_counts();
+      for (auto a : analysers) {
+        a->operator()(evs.data(), w.data(), bs);
+      }
+      analysis = analysis + (current_allocation_counts() - start);
+    }
+
+    start = current_allocation_counts();
+    bxsec(m, analysers);
+    block = current_allocation_counts() - start;
+
+    if (!pass) { generation = analysis = allocation_counts(); }
+  }
+
+  cout << "Heap traffic of " << n << " events after the warm-up:" << endl
+       << "  scalar loop:          " << scalar     << endl
+       << "  block generation:     " << generation << endl
+       << "  block analysis:       " << analysis   << endl
+       << "  block_integral:       " << block      << endl;
+
+  bool ok = scalar.allocations == 0 && generation.allocations == 0 &&
+            analysis.allocations == 0 && block.allocations == 0;
+
+  cout << (ok ? "no allocations in the event loops" : "FAILED: the event loops allocate") << endl;
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char ** argv)
 {
+  // model parameters, can be changed from the command line
+  resonance_model model;
+
+  // kinematic cuts, switched on by any cut option
+  kinematic_cuts cuts;
+  bool           use_cuts = false;
+
+  // run parameters
+  double events    = 1000000; // zawed events bra7tk ba2a!!
+  double pipeline  = 0;       // number of generator threads in pipeline mode
+  double block     = 0;       // events per block in stage-wise block mode
+  double threads   = 0;       // number of worker threads in parallel mode
+  string affinity  = "none";  // pinning of the worker threads
+  double workers   = 0;       // number of worker processes in forked mode
+  bool   profile   = false;   // hardware counters around generation and analysis
+  bool   check     = false;   // count the heap allocations of the event loops
+  bool   weights   = false;   // monitor the weight distribution
+  double progress  = 0;       // seconds between progress reports
+  string status;              // file with the last progress report
+  double qmc       = 0;       // number of replicas in quasi Monte Carlo mode
+  bool   miser     = false;   // recursive stratified sampling
+  double adaptive  = 0;       // bins of the equal statistics pT distribution
+  bool   pT_y      = false;   // the pT vs. rapidity distribution
+
+  for (int i = 1; i < argc; i++) {
+    if (option(argv[i], "events",   events  )) continue;
+    if (option(argv[i], "pipeline", pipeline)) continue;
+    if (option(argv[i], "block",    block   )) continue;
+    if (option(argv[i], "threads",  threads )) continue;
+    if (option(argv[i], "affinity", affinity)) continue;
+    if (option(argv[i], "workers",  workers )) continue;
+    if (strcmp(argv[i], "--profile") == 0) { profile = true; continue; }
+    if (strcmp(argv[i], "--check-allocations") == 0) { check = true; continue; }
+    if (strcmp(argv[i], "--weights") == 0) { weights = true; continue; }
+    if (option(argv[i], "progress", progress)) continue;
+    if (option(argv[i], "status",   status  )) continue;
+    if (option(argv[i], "qmc",      qmc     )) continue;
+    if (strcmp(argv[i], "--miser") == 0) { miser = true; continue; }
+    if (option(argv[i], "adaptive-pT", adaptive)) continue;
+    if (strcmp(argv[i], "--pT-y") == 0) { pT_y = true; continue; }
+    if (option(argv[i], "mB",    model.mB   )) continue;
+    if (option(argv[i], "gB",    model.gB   )) continue;
+    if (option(argv[i], "alpha", model.alpha)) continue;
+    if (option(argv[i], "vl",    model.vl   )) continue;
+    if (option(argv[i], "al",    model.al   )) continue;
+    if (option(argv[i], "pTmin", cuts.pT_min)) { use_cuts = true; continue; }
+    if (option(argv[i], "pTmax", cuts.pT_max)) { use_cuts = true; continue; }
+    if (option(argv[i], "ymax",  cuts.y_max )) { use_cuts = true; continue; }
+    if (option(argv[i], "mmin",  cuts.m_min )) { use_cuts = true; continue; }
+    if (option(argv[i], "mmax",  cuts.m_max )) { use_cuts = true; continue; }
+    cerr << "usage: " << argv[0]
+         << " [--events=1000000] [--pipeline=threads] [--block=1024] [--threads=n] [--workers=n] [--profile] [--check-allocations] [--weights]"
+         << " [--progress=seconds] [--status=file] [--qmc=replicas] [--miser] [--adaptive-pT=bins] [--pT-y]"
+         << " [--affinity=none|compact|scatter|cpu,cpu-cpu,...]"
+         << " [--mB=270] [--gB=17] [--alpha=0.00775] [--vl=2.65] [--al=0.73]"
+         << " [--pTmin=x] [--pTmax=x] [--ymax=x] [--mmin=x] [--mmax=x]" << endl;
+    return 1;
+  }
+
   qcd_hadron       pdf1;       // incoming hadron
   qcd_antihadron   pdf2(pdf1); // incoming antihadron
-  me_pp_to_llbar   me;         // matrix element
+  me_pp_to_llbar   me(model);  // matrix element
 
   // MC integral
-  mc_integral xsec(14000.0, &pdf1, &pdf2, &me);
+  mc_integral xsec(14000.0, &pdf1, &pdf2, &me, use_cuts ? &cuts : 0);
 
   // analysers
-  total_xsection tot1, tot2;
-  pT_dist        pT;
+  total_xsection     tot1, tot2;
+  pT_dist            pT;
+  concurrent_pT_dist cpT(threads >= 1 ? static_cast<unsigned long>(threads) : 1);
+  weight_monitor     wm;
+  pT_y_dist          pTy;
+
+  // the analysers of every mode, the worker threads fill one shared pT
+  // histogram instead of a copy each
+  analyser         * pT_result = threads >= 1 ? static_cast<analyser *>(&cpT) : &pT;
+  vector<analyser *> analysers = {&tot1, &tot2, pT_result};
+  if (weights) { analysers.push_back(&wm);  }
+  if (pT_y)    { analysers.push_back(&pTy); }
+
+  unsigned long n        = static_cast<unsigned long>(events);
+  unsigned long rejected = 0;
+
+  // Only one event loop can run. --block alone selects the block loop, with
+  // --profile and --threads it only sets the block size.
+  int modes = check + profile + (qmc >= 1) + miser + (workers >= 1)
+              + (pipeline >= 1) + (threads >= 1)
+              + (block >= 1 && !profile && threads < 1);
+  if (modes > 1) {
+    cerr << "--check-allocations, --profile, --qmc, --miser, --workers, --pipeline,"
+         << " --threads and --block select different event loops, give only one" << endl;
+    return 2;
+  }
 
-  // Generate event and calculate the cross section.
-  for (unsigned long k = 0; k < 1000000; ++k ) { // zawed events bra7tk ba2a!!
-    xsec({&tot1, &tot2, &pT});
+  // The progress monitor is only wired into the default event loop.
+  bool default_loop = modes == 0;
+  if (!default_loop && (progress > 0 || !status.empty())) {
+    cerr << "--progress and --status only work in the default event loop" << endl;
+    return 1;
+  }
+
+  // The equal statistics binning is learned from a serial warm-up on a copy
+  // of the integral before the event loop, so every mode can clone it.
+  adaptive_pT_dist apT(adaptive >= 1 ? static_cast<unsigned long>(adaptive) : 20);
+  if (adaptive >= 1) {
+    mc_integral warm_up(xsec);
+    event       ev;
+    while (!apT.frozen()) {
+      double w = warm_up.generate(ev);
+      apT(ev, w);
+    }
+    analysers.push_back(&apT);
+  }
+
+  if (check) {
+    block_integral bxsec(14000.0, &pdf1, &pdf2, &me, use_cuts ? &cuts : 0);
+    return check_allocations(xsec, bxsec, n, analysers);
+  } else if (profile) {
+    // Blocks of events, with hardware counters around the generation and
+    // the analysis of every block.
+    perf_counters generation, analysis;
+    unsigned long bs = block >= 1 ? static_cast<unsigned long>(block) : 1024;
+    vector<event>  evs(bs);
+    vector<double> w  (bs);
+
+    for (unsigned long done = 0; done < n; done += bs) {
+      unsigned long m = n - done < bs ? n - done : bs;
+
+      generation.start();
+      for (unsigned long k = 0; k < m; k++) {
+        w[k] = xsec.generate(evs[k]);
+      }
+      generation.stop();
+
+      analysis.start();
+      for (auto a : analysers) {
+        a->operator()(evs.data(), w.data(), m);
+      }
+      analysis.stop();
+    }
+    rejected = xsec.number_of_rejected();
+
+    generation.print(cout, "generation", n);
+    analysis  .print(cout, "analysis",   n);
+  } else if (qmc >= 1) {
+    // Scrambled Sobol points, the events are split among the replicas. The
+    // replicas must have equal size, best a power of 2.
+    unsigned long replicas = static_cast<unsigned long>(qmc);
+    unsigned long points   = n/replicas;
+    if (points == 0 || points*replicas != n) {
+      cerr << "--events=" << n << " is not a positive multiple of --qmc=" << replicas << endl;
+      return 1;
+    }
+    if ((points & (points - 1)) != 0) {
+      cerr << "warning: " << points << " points per replica is not a power of 2,"
+           << " the Sobol points are not balanced" << endl;
+    }
+    qmc_integral  qxsec(14000.0, &pdf1, &pdf2, &me, use_cuts ? &cuts : 0);
+    qxsec(points, replicas, analysers);
+    rejected = qxsec.number_of_rejected();
+    qxsec.print(std::cout);
+  } else if (miser) {
+    // Recursive stratified sampling of the generator random numbers. The
+    // events include the presamples, which are not analysed, the printout
+    // says how many were.
+    miser_integral mxsec(14000.0, &pdf1, &pdf2, &me, use_cuts ? &cuts : 0);
+    mxsec(n, analysers);
+    rejected = mxsec.number_of_rejected();
+    mxsec.print(std::cout);
+  } else if (workers >= 1) {
+    // Worker processes, for pdfs and matrix elements which are not thread safe.
+    forked_integral fxsec(14000.0, &pdf1, &pdf2, &me, use_cuts ? &cuts : 0);
+    try {
+      fxsec(n, static_cast<unsigned long>(workers), analysers);
+    } catch (const exception & error) {
+      cerr << error.what() << endl;
+      return 1;
+    }
+    rejected = fxsec.number_of_rejected();
+  } else if (pipeline >= 1) {
+    // Generator threads feed one analysis thread.
+    unsigned long         ngen = static_cast<unsigned long>(pipeline);
+    vector<mc_integral>   gens(ngen, xsec);
+    vector<mc_integral *> pgens;
+    for (auto & g : gens) { pgens.push_back(&g); }
+
+    analysis_pipeline pipe;
+    pipe.run(pgens, n, {analysers});
+
+    for (auto & g : gens) { rejected += g.number_of_rejected(); }
+  } else if (threads >= 1) {
+    // Blocks of events shared out to worker threads.
+    parallel_integral pxsec(14000.0, &pdf1, &pdf2, &me, use_cuts ? &cuts : 0);
+    try {
+      pxsec.set_affinity(affinity_policy::parse(affinity));
+    } catch (const invalid_argument & error) {
+      cerr << error.what() << endl;
+      return 1;
+    }
+    try {
+      pxsec(n, block >= 1 ? static_cast<unsigned long>(block) : 1024,
+            static_cast<unsigned long>(threads), analysers);
+    } catch (const exception & error) {
+      cerr << error.what() << endl;
+      return 1;
+    }
+    rejected = pxsec.number_of_rejected();
+  } else if (block >= 1) {
+    // Stage by stage, block by block.
+    block_integral bxsec(14000.0, &pdf1, &pdf2, &me, use_cuts ? &cuts : 0,
+                         static_cast<unsigned long>(block));
+    bxsec(n, analysers);
+    rejected = bxsec.number_of_rejected();
+    bxsec.print_timings(std::cout);
+  } else {
+    // Generate event and calculate the cross section.
+    // progress reports to stderr and the status file
+    progress_monitor monitor(n, progress > 0 ? progress : 10.0, progress > 0 ? &cerr : 0, status);
+    bool             monitored = progress > 0 || !status.empty();
+    if (monitored) {
+      analysers.push_back(&monitor);
+      monitor.start();
+    }
+
+    for (unsigned long k = 0; k < n; ++k ) {
+      xsec(analysers);
+    }
+
+    if (monitored) { monitor.stop(); }
+    rejected = xsec.number_of_rejected();
   }
 
   // Print the results.
+  if (use_cuts) {
+    cout << "Cuts: " << cuts << ", rejected " << rejected << " events" << endl;
+  }
   tot1.print(std::cout);
   tot2.print(std::cout);
-  pT.print  (std::cout);
+  pT_result->print(std::cout);
+  if (wm._M_number_of_events > 0) {
+    wm.print(std::cout);
+  }
+  if (adaptive >= 1) {
+    apT.print(std::cout);
+  }
+  if (pT_y) {
+    pTy.print(std::cout);
+  }
+
+#ifdef SCHOOL_INSTRUMENT
+  xsec.print_profile(std::cout);
+#endif
 
   return 0;
 }
@@ -8,6 +8,8 @@
 
 #include "event.h"
 
+#include <stdexcept>
+
 namespace school {
 
   // The matrix_element will be an abstract base class with 2 abstract methods
@@ -31,6 +33,21 @@ namespace school {
      */
     virtual void set_flavors(event &) const = 0;
 
+    /** \brief Resize the event and choose the flavors from the uniform
+     * random numbers in u, for quasi-random sampling.
+     *
+     * The default throws std::logic_error.
+     */
+    virtual void set_flavors(event &, const value_type *) const {
+      throw std::logic_error("this matrix element cannot take explicit random numbers");
+    }
+
+    /** \brief Number of uniform random numbers set_flavors(event&, u) takes.
+     */
+    virtual event::size_type flavor_dimension() const {
+      throw std::logic_error("this matrix element cannot take explicit random numbers");
+    }
+
   }; // end of struct matrix_element
 
 } // end of namespace school
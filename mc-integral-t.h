@@ -0,0 +1,227 @@
+/**
+ * \file
+ * \brief Definition of the mc_integral_t class template.
+ */
+
+#ifndef __SCHOOL_MC_INTEGRAL_T_H__
+#define __SCHOOL_MC_INTEGRAL_T_H__ 1
+
+#include "event.h"
+#include "cuts.h"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace school {
+
+  /** \brief Statically bound MC integral.
+   *
+   * This does the same as mc_integral, but the matrix element, the two pdfs
+   * and the analysers are template parameters instead of base class pointers.
+   * Every call is made with a qualified name (ME::operator(), PDF1::parton,
+   * A::analyze), which switches off the virtual dispatch. The compiler can
+   * then inline the whole event loop of run() into one function. The
+   * analysers are kept by reference, so the results can be printed from the
+   * original objects after the run. The cuts and the block interface work as
+   * in mc_integral.
+   *
+   * \code
+   * qcd_hadron                   pdf1;
+   * qcd_antihadron_t<qcd_hadron> pdf2(pdf1);
+   * me_pp_to_llbar               me;
+   * total_xsection               tot;
+   * pT_dist                      pT;
+   *
+   * auto xsec = make_mc_integral(14000.0, pdf1, pdf2, me, tot, pT);
+   * xsec.run(1000000);
+   * \endcode
+   */
+  template <class ME, class PDF1, class PDF2, class... Analysers>
+  class mc_integral_t {
+
+  public:
+
+    typedef event::value_type value_type;
+    typedef event::size_type  size_type;
+
+  private:
+
+    value_type   _M_Ecm;
+    const PDF1 & _M_pdf1;
+    const PDF2 & _M_pdf2;
+    const ME   & _M_me;
+
+    /** \brief The cuts, no cuts if null.
+     */
+    const kinematic_cuts * _M_cuts;
+
+    /** \brief The analysers, called in the order they were given.
+     */
+    std::tuple<Analysers & ...> _M_analysers;
+
+    size_type  _M_number_of_rejected;
+    event      _TMP_p;
+    value_type _TMP_weight;
+
+    /** \brief Events and weights of the last block.
+     */
+    std::vector<event>      _TMP_block;
+    std::vector<value_type> _TMP_block_weights;
+
+  public:
+
+    mc_integral_t(
+      value_type     Ecm ,
+      const PDF1   & pdf1,
+      const PDF2   & pdf2,
+      const ME     & me  ,
+      Analysers  & ... ah
+    ) :
+    _M_Ecm      (Ecm   ),
+    _M_pdf1     (pdf1  ),
+    _M_pdf2     (pdf2  ),
+    _M_me       (me    ),
+    _M_cuts     (0     ),
+    _M_analysers(ah... ),
+    _M_number_of_rejected(0),
+    _TMP_weight (0.0   ) {
+    }
+
+    mc_integral_t(const mc_integral_t &)               = default;
+    mc_integral_t & operator = (const mc_integral_t &) = delete;
+
+    /** \brief Apply cuts, rejected events get zero weight.
+     */
+    void set_cuts(const kinematic_cuts * cuts) {
+      _M_cuts = cuts;
+    }
+
+    /** \brief Number of events rejected by the cuts.
+     */
+    size_type number_of_rejected() const {
+      return _M_number_of_rejected;
+    }
+
+    /** \brief Generate an event into ev and return its weight.
+     */
+    value_type generate(event & ev) {
+
+      // Setting the flavours, this resizes ev
+      _M_me.ME::set_flavors(ev);
+
+      // Generate the momenta.
+      value_type weight = generate_event(ev, _M_Ecm);
+
+      // Apply the cuts before the expensive parts.
+      if (_M_cuts && !_M_cuts->operator()(ev)) {
+        ++_M_number_of_rejected;
+        return 0.0;
+      }
+
+      // From here on the momenta stay, the const view keeps the invariants.
+      const event & cev = ev;
+
+      // For factorization scale we use shat.
+      value_type shat = cev.s(-1,0);
+
+      // Calculate the pdfs.
+      weight *= _M_pdf1.PDF1::parton(cev[-1].flavor, cev.xa, shat);
+      weight *= _M_pdf2.PDF2::parton(cev[ 0].flavor, cev.xb, shat);
+
+      // Calculate the matrix element.
+      weight *= _M_me.ME::operator()(cev);
+
+      return weight;
+    }
+
+    /** \brief Generate one event and analyse it.
+     */
+    void operator () () {
+      _TMP_weight = this->generate(_TMP_p);
+      _M_analyze<0>();
+    }
+
+    /** \brief Generate a block of n events and analyse them with one call
+     * per analyser.
+     */
+    void operator () (size_type n) {
+
+      if (_TMP_block.size() < n) {
+        _TMP_block.resize(n);
+        _TMP_block_weights.resize(n);
+      }
+
+      for (size_type k = 0; k < n; k++) {
+        _TMP_block_weights[k] = this->generate(_TMP_block[k]);
+      }
+
+      _M_analyze_batch<0>(n);
+    }
+
+    /** \brief Generate and analyse n events.
+     */
+    void run(size_type n) {
+      for (size_type k = 0; k < n; ++k) {
+        this->operator()();
+      }
+    }
+
+    /** \brief Returns the last event.
+     */
+    std::pair<value_type, const event &> last_event() const {
+      return {_TMP_weight, _TMP_p};
+    }
+
+  private:
+
+    // End of the recursion over the analysers.
+    template <std::size_t I>
+    typename std::enable_if<I == sizeof...(Analysers)>::type _M_analyze() {
+    }
+
+    // Call the I-th analyser and go on with the next one.
+    template <std::size_t I>
+    typename std::enable_if<I < sizeof...(Analysers)>::type _M_analyze() {
+      typedef typename std::tuple_element<I, std::tuple<Analysers...> >::type A;
+      A & ana = std::get<I>(_M_analysers);
+      ana.A::analyze(_TMP_p, _TMP_weight);
+      ++ana._M_number_of_events;
+      _M_analyze<I+1>();
+    }
+
+    // End of the recursion over the analysers of a block.
+    template <std::size_t I>
+    typename std::enable_if<I == sizeof...(Analysers)>::type _M_analyze_batch(size_type) {
+    }
+
+    // Call the I-th analyser with the block and go on with the next one.
+    template <std::size_t I>
+    typename std::enable_if<I < sizeof...(Analysers)>::type _M_analyze_batch(size_type n) {
+      typedef typename std::tuple_element<I, std::tuple<Analysers...> >::type A;
+      A & ana = std::get<I>(_M_analysers);
+      ana.A::analyze_batch(_TMP_block.data(), _TMP_block_weights.data(), n);
+      ana._M_number_of_events += n;
+      _M_analyze_batch<I+1>(n);
+    }
+
+  }; // end of class mc_integral_t
+
+  /** \brief Helper to deduce the template arguments of mc_integral_t.
+   */
+  template <class ME, class PDF1, class PDF2, class... Analysers>
+  mc_integral_t<ME, PDF1, PDF2, Analysers...> make_mc_integral(
+    event::value_type Ecm ,
+    const PDF1      & pdf1,
+    const PDF2      & pdf2,
+    const ME        & me  ,
+    Analysers     & ... ah
+  ) {
+    return mc_integral_t<ME, PDF1, PDF2, Analysers...>(Ecm, pdf1, pdf2, me, ah...);
+  }
+
+} // end of namespace school
+
+#endif
@@ -7,22 +7,97 @@ using namespace std;
 namespace school {
 
   void mc_integral::operator () () {
+    _TMP_weight = this->generate(_TMP_p);
+  }
+
+  mc_integral::value_type mc_integral::generate(event & ev) {
+
+    SCHOOL_PROFILE_START(t);
 
-    // Setting the flavours, this resizes _TMP_p
-    _M_me->set_flavors(_TMP_p);
+    // Setting the flavours, this resizes ev
+    _M_me->set_flavors(ev);
+    SCHOOL_PROFILE_LAP(_M_profile, stage_flavors, t);
 
     // Generate the momenta.
-    _TMP_weight = generate_event(_TMP_p, _M_Ecm);
+    value_type weight = generate_event(ev, _M_Ecm);
+    SCHOOL_PROFILE_LAP(_M_profile, stage_phase_space, t);
+
+    // Apply the cuts before the expensive parts. Rejected events are still
+    // analysed (with zero weight), so the normalization stays right.
+    if (_M_cuts && !_M_cuts->operator()(ev)) {
+      ++_M_number_of_rejected;
+      SCHOOL_PROFILE_LAP(_M_profile, stage_cuts, t);
+      return 0.0;
+    }
+    SCHOOL_PROFILE_LAP(_M_profile, stage_cuts, t);
+
+    // From here on the momenta stay, the const view keeps the invariants.
+    const event & cev = ev;
 
     // For factorization scale we use shat.
-    value_type shat = (_TMP_p[-1].momentum+_TMP_p[0].momentum).mag2();
+    value_type shat = cev.s(-1,0);
 
     // Calculate the pdfs.
-    _TMP_weight *= _M_pdf1 -> parton(_TMP_p[-1].flavor, _TMP_p.xa, shat);
-    _TMP_weight *= _M_pdf2 -> parton(_TMP_p[ 0].flavor, _TMP_p.xb, shat);
+    weight *= _M_pdf1 -> parton(cev[-1].flavor, cev.xa, shat);
+    SCHOOL_PROFILE_LAP(_M_profile, stage_pdf1, t);
+    weight *= _M_pdf2 -> parton(cev[ 0].flavor, cev.xb, shat);
+    SCHOOL_PROFILE_LAP(_M_profile, stage_pdf2, t);
 
     // Calculate the matrix element.
-    _TMP_weight *= _M_me -> operator()(_TMP_p);
+    weight *= _M_me -> operator()(ev);
+    SCHOOL_PROFILE_LAP(_M_profile, stage_me, t);
+
+    return weight;
+  }
+
+  mc_integral::value_type mc_integral::generate(event & ev, const value_type * u) {
+
+    _M_me->set_flavors(ev, u);
+    value_type weight = generate_event(ev, _M_Ecm, u + _M_me->flavor_dimension());
+
+    if (_M_cuts && !_M_cuts->operator()(ev)) {
+      ++_M_number_of_rejected;
+      return 0.0;
+    }
+
+    const event & cev = ev;
+    value_type    shat = cev.s(-1,0);
+
+    weight *= _M_pdf1 -> parton(cev[-1].flavor, cev.xa, shat);
+    weight *= _M_pdf2 -> parton(cev[ 0].flavor, cev.xb, shat);
+    weight *= _M_me -> operator()(ev);
+
+    return weight;
+  }
+
+  event::size_type mc_integral::dimension() const {
+
+    // the flavors fix the number of outgoings
+    event                   ev;
+    std::vector<value_type> u(_M_me->flavor_dimension(), 0.5);
+    _M_me->set_flavors(ev, u.data());
+
+    return _M_me->flavor_dimension() + generate_event_dimension(ev.number_of_outgoings());
+  }
+
+  void mc_integral::operator () (event::size_type n, const std::vector<analyser*> & ah) {
+
+    if (_TMP_block.size() < n) {
+      _TMP_block.resize(n);
+      _TMP_block_weights.resize(n);
+    }
+
+    // Generate the events in place.
+    for (event::size_type k = 0; k < n; k++) {
+      _TMP_block_weights[k] = this->generate(_TMP_block[k]);
+    }
+
+    // Analyse the whole block.
+    SCHOOL_PROFILE_START(t);
+    for (auto iter = ah.begin(); iter != ah.end(); ++iter) {
+      (*iter)->operator()(_TMP_block.data(), _TMP_block_weights.data(), n);
+      SCHOOL_PROFILE_LAP(_M_profile, stage_analysers + (iter - ah.begin()), t);
+    }
   }
 
 } // end of namespace school
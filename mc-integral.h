@@ -7,9 +7,12 @@
 #include "matrix-element.h"
 #include "qcd-pdf.h"
 #include "analyser.h"
+#include "cuts.h"
+#include "stage-profile.h"
 
 #include <initializer_list> //to use of initializer list syntax to initialize types
 #include <utility>
+#include <vector>
 
 namespace school {// the used name space !!
   class mc_integral {
@@ -24,25 +27,62 @@ namespace school {// the used name space !!
     const qcd_hadron_base *_M_pdf1;
     const qcd_hadron_base *_M_pdf2;
     const matrix_element *_M_me;
+    const kinematic_cuts *_M_cuts; // no cuts if null
+    event::size_type _M_number_of_rejected;
     mutable event  _TMP_p; // allow to be changed inside the const methods
     mutable value_type _TMP_weight;
+    std::vector<event> _TMP_block; // events and weights of the last block
+    std::vector<value_type> _TMP_block_weights;
+
+#ifdef SCHOOL_INSTRUMENT
+    stage_profile _M_profile; // time spent in every stage
+#endif
 
   public:
     mc_integral(
       value_type             Ecm ,
       const qcd_hadron_base *pdf1,
       const qcd_hadron_base *pdf2,
-      const matrix_element  *me
+      const matrix_element  *me  ,
+      const kinematic_cuts  *cuts = 0
     ) :
     _M_Ecm  (Ecm ),
     _M_pdf1 (pdf1),
     _M_pdf2 (pdf2),
-    _M_me   (me  ) {
+    _M_me   (me  ),
+    _M_cuts (cuts),
+    _M_number_of_rejected(0)
+#ifdef SCHOOL_INSTRUMENT
+    , _M_profile({"set_flavors", "generate_event", "cuts", "pdf1", "pdf2", "matrix element"}, "analyser")
+#endif
+    {
     }
 
+    // Stages of the instrumentation, the analysers come after them.
+    enum stage_type { stage_flavors, stage_phase_space, stage_cuts, stage_pdf1, stage_pdf2, stage_me, stage_analysers };
+
 
     void operator () ();// mogoda fy el cc
 
+    //Generate an event into ev and return its weight.
+
+    value_type generate(event & ev);
+
+    //Generate an event from the uniform random numbers in u, dimension() of
+    //them: first the flavors, then the phase space (for quasi-random sampling).
+
+    value_type generate(event & ev, const value_type * u);
+
+    //Number of uniform random numbers of an event.
+
+    event::size_type dimension() const;
+
+    //Number of events rejected by the cuts, they got zero weight.
+
+    event::size_type number_of_rejected() const {
+      return _M_number_of_rejected;
+    }
+
     //Returns the last event.
 
     std::pair<value_type, const event &> last_event() const {
@@ -50,12 +90,44 @@ namespace school {// the used name space !!
     }
     
     
+    //  Print the time spent in every stage, if compiled with SCHOOL_INSTRUMENT.
+
+    std::ostream & print_profile(std::ostream & os) const {
+#ifdef SCHOOL_INSTRUMENT
+      return _M_profile.print(os);
+#else
+      return os << "# compiled without SCHOOL_INSTRUMENT, no stage timings" << std::endl;
+#endif
+    }
+
     //  Generate one event and analyse it.
 
     void operator () (std::initializer_list<analyser*> ah) {
       this->operator()();
-      for(auto iter : ah) {
-        iter->operator()(_TMP_p, _TMP_weight);
+      this->_M_analyze(ah.begin(), ah.end());
+    }
+
+    //  Same with a list of analysers made at run time.
+
+    void operator () (const std::vector<analyser*> & ah) {
+      this->operator()();
+      this->_M_analyze(ah.begin(), ah.end());
+    }
+
+    //  Generate a block of n events and analyse them with one call per analyser.
+
+    void operator () (event::size_type n, const std::vector<analyser*> & ah);
+
+  private:
+
+    //  Analyse the last event.
+
+    template <class Iterator>
+    void _M_analyze(Iterator first, Iterator last) {
+      SCHOOL_PROFILE_START(t);
+      for(auto iter = first; iter != last; ++iter) {
+        (*iter)->operator()(_TMP_p, _TMP_weight);
+        SCHOOL_PROFILE_LAP(_M_profile, stage_analysers + (iter - first), t);
       }
     }
 
@@ -0,0 +1,32 @@
+/**
+ * \file
+ * \brief Implementation of mc_scan members.
+ */
+
+#include "mc-scan.h"
+
+namespace school {
+
+  void mc_scan::operator () () {
+
+    // Setting the flavours, this resizes _TMP_p
+    _M_me->set_flavors(_TMP_p);
+
+    // Generate the momenta.
+    value_type weight = generate_event(_TMP_p, _M_Ecm);
+
+    // From here on the momenta stay, the const view keeps the invariants.
+    const event & ev = _TMP_p;
+
+    // For factorization scale we use shat.
+    value_type shat = ev.s(-1,0);
+
+    // Calculate the pdfs.
+    weight *= _M_pdf1 -> parton(ev[-1].flavor, ev.xa, shat);
+    weight *= _M_pdf2 -> parton(ev[ 0].flavor, ev.xb, shat);
+
+    // Calculate the matrix element for every grid point.
+    _M_me -> operator()(_TMP_p, _TMP_weights.data(), weight);
+  }
+
+} // end of namespace school
@@ -0,0 +1,80 @@
+/**
+ * \file
+ * \brief Definition of the mc_scan class.
+ */
+
+#ifndef __SCHOOL_MC_SCAN_H__
+#define __SCHOOL_MC_SCAN_H__ 1
+
+#include "event.h"
+#include "qcd-pdf.h"
+#include "me-pp-to-llbar-scan.h"
+#include "scan-analyser.h"
+
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace school {
+
+  /** \brief MC integral for a parameter scan.
+   *
+   * Like mc_integral, but the phase space point and the pdfs are calculated
+   * only once and the matrix element is evaluated for every grid point of the
+   * scan. So the whole scan costs a little more than a single run.
+   */
+  class mc_scan {
+
+  public:
+
+    typedef event::value_type value_type;
+
+  private:
+
+    value_type                 _M_Ecm;
+    const qcd_hadron_base     *_M_pdf1;
+    const qcd_hadron_base     *_M_pdf2;
+    const me_pp_to_llbar_scan *_M_me;
+
+    event                   _TMP_p;
+    std::vector<value_type> _TMP_weights;
+
+  public:
+
+    mc_scan(
+      value_type                 Ecm ,
+      const qcd_hadron_base     *pdf1,
+      const qcd_hadron_base     *pdf2,
+      const me_pp_to_llbar_scan *me
+    ) :
+    _M_Ecm      (Ecm ),
+    _M_pdf1     (pdf1),
+    _M_pdf2     (pdf2),
+    _M_me       (me  ),
+    _TMP_weights(me->stride(), 0.0) {
+    }
+
+    /** \brief Generate one event and calculate the weight of every grid point.
+     */
+    void operator () ();
+
+    /** \brief Returns the last event and its weights.
+     */
+    std::pair<const value_type *, const event &> last_event() const {
+      return {_TMP_weights.data(), _TMP_p};
+    }
+
+    /** \brief Generate one event and analyse it.
+     */
+    void operator () (std::initializer_list<scan_analyser*> ah) {
+      this->operator()();
+      for(auto iter : ah) {
+        iter->operator()(_TMP_p, _TMP_weights.data());
+      }
+    }
+
+  }; // end of class mc_scan
+
+} // end of namespace school
+
+#endif
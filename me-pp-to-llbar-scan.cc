@@ -0,0 +1,101 @@
+/**
+ * \file
+ * \brief Implementation of me_pp_to_llbar_scan members.
+ */
+
+#include "me-pp-to-llbar-scan.h"
+
+namespace school {
+
+  /** The kernel of the scan, nb blocks of 4 grid points. The block structure
+   * and the restrict qualifiers tell the compiler that it can vectorize the
+   * loop without a remainder loop and without run time alias checks.
+   */
+  static void __scan_kernel(
+    event::size_type                         nb,
+    event::value_type                        Q2,
+    event::value_type                        A,
+    event::value_type                        B,
+    const event::value_type * __restrict__   mB2,
+    const event::value_type * __restrict__   mBgB2,
+    const event::value_type * __restrict__   cp,
+    const event::value_type * __restrict__   cm,
+    event::value_type       * __restrict__   out
+  ) {
+    for (event::size_type k = 0; k < 4*nb; k++) {
+      event::value_type d = Q2 - mB2[k];
+      out[k] = (cp[k]*A + cm[k]*B) / (d*d + mBgB2[k]);
+    }
+  }
+
+  me_pp_to_llbar_scan::me_pp_to_llbar_scan(const std::vector<resonance_model> & grid) :
+  me_pp_to_llbar(grid.front()),
+  _M_grid       (grid),
+  _M_stride     ((grid.size()+3)/4*4),
+  _M_mB2        (_M_stride, 0.0),
+  _M_mBgB2      (_M_stride, 1.0),
+  _M_cplus      (_M_stride*resonance_model::number_of_flavors, 0.0),
+  _M_cminus     (_M_stride*resonance_model::number_of_flavors, 0.0) {
+
+    // The single model matrix element already knows how to fold the
+    // couplings and the constants, so we just copy its tables. The padding
+    // points have zero couplings and a harmless propagator.
+    for (size_type k = 0; k < _M_grid.size(); k++) {
+
+      me_pp_to_llbar me(_M_grid[k]);
+
+      _M_mB2  [k] = me._M_mB2;
+      _M_mBgB2[k] = me._M_mBgB2;
+
+      for (int f = 0; f < resonance_model::number_of_flavors; f++) {
+        _M_cplus [f*_M_stride+k] = me._M_cplus [f];
+        _M_cminus[f*_M_stride+k] = me._M_cminus[f];
+      }
+    }
+  }
+
+  std::vector<resonance_model> me_pp_to_llbar_scan::mass_width_grid(
+    const resonance_model & model,
+    value_type mB_min, value_type mB_max, size_type nmB,
+    value_type gB_min, value_type gB_max, size_type ngB
+  ) {
+
+    std::vector<resonance_model> res;
+    resonance_model              m = model;
+
+    value_type dmB = nmB > 1 ? (mB_max - mB_min) / (nmB - 1) : 0.0;
+    value_type dgB = ngB > 1 ? (gB_max - gB_min) / (ngB - 1) : 0.0;
+
+    for (size_type j = 0; j < ngB; j++) {
+      for (size_type i = 0; i < nmB; i++) {
+        m.mB = mB_min + i*dmB;
+        m.gB = gB_min + j*dgB;
+        res.push_back(m);
+      }
+    }
+
+    return res;
+  }
+
+  void me_pp_to_llbar_scan::operator () (const event & ev, value_type * me2, value_type factor) const {
+
+    // quark flavor index of the coupling tables
+    int f = std::abs(static_cast<int>(ev[0].flavor));
+
+    // anti-quark and quark index
+    event::index_type iqbar = static_cast<int>(ev[-1].flavor) < 0 ? -1 : 0;
+    event::index_type iq    = -1 - iqbar;
+
+    // everything that depends only on the phase space point
+    const value_type Q2 = 2.*ev.dot(iq,iqbar);
+    const value_type A  = factor * ev.dot(iq,1) * ev.dot(iqbar,2);
+    const value_type B  = factor * ev.dot(iqbar,1) * ev.dot(iq,2);
+
+    __scan_kernel(_M_stride/4, Q2, A, B,
+      _M_mB2.data(), _M_mBgB2.data(),
+      _M_cplus.data() + f*_M_stride, _M_cminus.data() + f*_M_stride,
+      me2
+    );
+  }
+
+} // end of namespace school
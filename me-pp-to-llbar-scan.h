@@ -0,0 +1,99 @@
+/**
+ * \file
+ * \brief Definition of the me_pp_to_llbar_scan class.
+ */
+
+#ifndef __SCHOOL_ME_PP_TO_LLBAR_SCAN_H__
+#define __SCHOOL_ME_PP_TO_LLBAR_SCAN_H__ 1
+
+#include "me-pp-to-llbar.h"
+
+#include <vector>
+
+namespace school {
+
+  /** \brief The me_pp_to_llbar matrix element on a grid of models.
+   *
+   * For every phase space point the matrix element is evaluated for all
+   * models of the grid at once. Everything that depends on the model is
+   * stored flavor by flavor in contiguous arrays (structure of arrays), so
+   * the loop over the grid points is a simple vectorizable kernel. Used as an
+   * ordinary matrix_element it gives the matrix element of the first model.
+   */
+  class me_pp_to_llbar_scan : public me_pp_to_llbar {
+
+  public:
+
+    typedef event::size_type size_type;
+
+    /** \brief Construct the scan from the grid of models.
+     *
+     * The grid must not be empty.
+     */
+    explicit me_pp_to_llbar_scan(const std::vector<resonance_model> & grid);
+
+    /** \brief Helper to make a grid in mB and gB around a model.
+     *
+     * The boson mass goes from mB_min to mB_max in nmB steps, the width from
+     * gB_min to gB_max in ngB steps (the mass runs fastest), every other
+     * parameter is taken from the model.
+     */
+    static std::vector<resonance_model> mass_width_grid(
+      const resonance_model & model,
+      value_type mB_min, value_type mB_max, size_type nmB,
+      value_type gB_min, value_type gB_max, size_type ngB
+    );
+
+    /** \brief Number of grid points.
+     */
+    size_type size() const {
+      return _M_grid.size();
+    }
+
+    /** \brief Number of grid points rounded up to a multiple of 4.
+     *
+     * This is the size of the output buffer the scan needs.
+     */
+    size_type stride() const {
+      return _M_stride;
+    }
+
+    /** \brief The k-th model of the grid.
+     */
+    const resonance_model & model(size_type k) const {
+      return _M_grid[k];
+    }
+
+    using me_pp_to_llbar::operator();
+
+    /** \brief Calculate the matrix element for every grid point.
+     *
+     * The k-th result multiplied by factor is written to me2[k]. The buffer
+     * must have room for stride() values, the ones after size() are padding.
+     */
+    void operator() (const event &, value_type * me2, value_type factor = 1.0) const;
+
+  private:
+
+    /** \brief The grid of models.
+     */
+    std::vector<resonance_model> _M_grid;
+
+    /** \brief Number of grid points rounded up to a multiple of 4.
+     */
+    size_type _M_stride;
+
+    /** \brief Propagator parameters per grid point.
+     */
+    std::vector<value_type> _M_mB2, _M_mBgB2;
+
+    /** \brief Coupling combinations, flavor f of grid point k is at
+     * f*_M_stride+k.
+     */
+    std::vector<value_type> _M_cplus, _M_cminus;
+
+  }; // end of class me_pp_to_llbar_scan
+
+} // end of namespace school
+
+#endif
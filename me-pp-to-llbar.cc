@@ -6,7 +6,7 @@
 #include "me-pp-to-llbar.h"
 #include "school-rng.h"
 
-#include <cfloat>
+#include <cmath>
 
 // This is for local use only
 static inline
@@ -17,61 +17,31 @@ sqr(school::matrix_element::value_type x) {
 
 namespace school {
 
-  matrix_element::value_type me_pp_to_llbar::operator () (const event & ev) const {
+  me_pp_to_llbar::me_pp_to_llbar(const resonance_model & model) :
+  _M_model(model),
+  _M_mB2  (sqr(model.mB)),
+  _M_mBgB2(sqr(model.mB*model.gB)) {
 
-    // Boson mass
-    const value_type mB = 270.0;
+    const value_type vq = model.vl;
+    const value_type aq = model.al;
 
-    // Boson width
-    const value_type gB = 17.0;
-
-    // alpha
-    const value_type alpha = 1.0/129.0;
-
-    // electron vector coupling
-    const value_type vq = 2.65;
-
-    // electorn axial coupling
-    const value_type aq = 0.73;
-
-    // quark vector coupling
-    value_type vp = abs(static_cast<int>(ev[0].flavor))%2 == 0 ? 5.3 : -3.9;
-
-    // quark axial coupling
-    value_type ap = abs(static_cast<int>(ev[0].flavor))%2 == 0 ? 3.6 : -4.2;
-
-    // anti-quark momentum
-    const lorentzvector & pbar = static_cast<int>(ev[-1].flavor) < 0 ? ev[-1].momentum : ev[0].momentum;
-
-    // quark momentum
-    const lorentzvector & p = static_cast<int>(ev[-1].flavor) < 0 ? ev[0].momentum : ev[-1].momentum;
-
-    // positron momentum
-    const lorentzvector & qbar = ev[1].momentum;
-
-    // electron momentum
-    const lorentzvector & q = ev[2].momentum;
-
-    // overall constants and propagator factor
-    value_type Q2     = 2.*p*pbar;
-    value_type bw     = 1./(sqr(Q2-sqr(mB))+sqr(mB*gB));
-    value_type factor = 32.*3.0*sqr(4.*M_PI*alpha)*bw;
-
-    // matrix element squared
-    value_type me2 =
-      factor * (
-        ( sqr(vp*aq+vq*ap) + sqr(vp*vq+ap*aq) ) * (p*qbar) * (pbar*q) +
-        ( sqr(vp*aq-vq*ap) + sqr(vp*vq-ap*aq) ) * (pbar*qbar) * (p*q)
-      );
+    // overall constants
+    value_type factor = 32.*3.0*sqr(4.*M_PI*model.alpha);
 
     // we need to avearge over spins and colors
-    me2 /= 2.0*3.0*3.0;
+    factor /= 2.0*3.0*3.0;
 
     // we need to divide by the probabilities with which flavors and
     // beams have been selected
-    me2 *= 2.0*5.0;
+    factor *= 2.0*5.0;
 
-    return me2;
+    for (int f = 0; f < resonance_model::number_of_flavors; f++) {
+      const value_type vp = model.vq[f];
+      const value_type ap = model.aq[f];
+
+      _M_cplus [f] = factor * ( sqr(vp*aq+vq*ap) + sqr(vp*vq+ap*aq) );
+      _M_cminus[f] = factor * ( sqr(vp*aq-vq*ap) + sqr(vp*vq-ap*aq) );
+    }
   }
 
   void me_pp_to_llbar::set_flavors(event & ev) const {
@@ -93,4 +63,23 @@ namespace school {
     }
   }
 
+  void me_pp_to_llbar::set_flavors(event & ev, const value_type * u) const {
+
+    ev.resize(2);
+
+    ev[1].flavor = flavor_type::electron;
+    ev[2].flavor = flavor_type::positron;
+
+    // the same distribution as uniform_int_distribution<int>(1,5)
+    int quark_flavor = 1 + static_cast<int>(5.0*u[0]);
+    if (quark_flavor > 5) { quark_flavor = 5; }
+
+    ev[-1].flavor = static_cast<flavor_type>( quark_flavor);
+    ev[ 0].flavor = static_cast<flavor_type>(-quark_flavor);
+
+    if (u[1] >= 0.5) {
+      std::swap(ev[-1].flavor, ev[0].flavor);
+    }
+  }
+
 } // end of namespace school
\ No newline at end of file
@@ -8,13 +8,70 @@
 
 #include "matrix-element.h"
 
+#include <cstdlib>
+
 namespace school {
 
+  /** \brief Parameters of the resonance model used by me_pp_to_llbar.
+   *
+   * The default constructor sets the values we always used. The quark
+   * couplings are indexed by the absolute value of the quark flavor.
+   */
+  struct resonance_model {
+
+    typedef event::value_type value_type;
+
+    /** \brief Number of entries in the per-flavor tables (gluon..top). */
+    static const int number_of_flavors = 7;
+
+    value_type mB;    ///< Boson mass
+    value_type gB;    ///< Boson width
+    value_type alpha; ///< Electroweak coupling
+
+    value_type vl; ///< Lepton vector coupling
+    value_type al; ///< Lepton axial coupling
+
+    value_type vq[number_of_flavors]; ///< Quark vector couplings
+    value_type aq[number_of_flavors]; ///< Quark axial couplings
+
+    /** \brief The default model.
+     */
+    resonance_model() :
+    mB   (270.0),
+    gB   (17.0),
+    alpha(1.0/129.0),
+    vl   (2.65),
+    al   (0.73) {
+      for (int f = 0; f < number_of_flavors; f++) {
+        vq[f] = f%2 == 0 ? 5.3 :  -3.9;
+        aq[f] = f%2 == 0 ? 3.6 :  -4.2;
+      }
+    }
+
+  }; // end of struct resonance_model
+
   /** \brief A matrix element implementation.
+   *
+   * The flavor dependent coupling combinations and the overall constants are
+   * calculated once in the constructor, so per event we only need the dot
+   * products and the propagator.
    */
   struct me_pp_to_llbar : public matrix_element {
 
+    /** \brief Construct the matrix element for a given model.
+     */
+    explicit me_pp_to_llbar(const resonance_model & model = resonance_model());
+
+    /** \brief The model parameters.
+     */
+    const resonance_model & model() const {
+      return _M_model;
+    }
+
     /** \brief Calculate the matrix element.
+     *
+     * Defined inline below, so that mc_integral_t can inline it into its
+     * event loop.
      */
     value_type operator() (const event &) const;
 
@@ -22,8 +79,59 @@ namespace school {
      */
     void set_flavors(event &) const;
 
+    /** \brief Resize the event and choose the flavors from u[0] (the quark
+     * flavor) and u[1] (the beam of the quark).
+     */
+    void set_flavors(event &, const value_type * u) const;
+
+    event::size_type flavor_dimension() const {
+      return 2;
+    }
+
+  private:
+
+    // The scan reuses the coupling tables.
+    friend class me_pp_to_llbar_scan;
+
+    /** \brief The model parameters.
+     */
+    resonance_model _M_model;
+
+    /** \brief mB^2 and (mB*gB)^2 of the propagator.
+     */
+    value_type _M_mB2, _M_mBgB2;
+
+    /** \brief Coupling combinations multiplying (p*qbar)(pbar*q) and
+     * (pbar*qbar)(p*q), including every overall factor, per quark flavor.
+     */
+    value_type _M_cplus [resonance_model::number_of_flavors];
+    value_type _M_cminus[resonance_model::number_of_flavors];
+
   }; // end of struct me_pp_to_llbar
 
+  inline matrix_element::value_type me_pp_to_llbar::operator () (const event & ev) const {
+
+    // quark flavor index of the coupling tables
+    int f = std::abs(static_cast<int>(ev[0].flavor));
+
+    // anti-quark and quark index
+    event::index_type iqbar = static_cast<int>(ev[-1].flavor) < 0 ? -1 : 0;
+    event::index_type iq    = -1 - iqbar;
+
+    // positron index is 1, electron index is 2, the dot products are taken
+    // from the invariant table of the event
+
+    // propagator factor
+    value_type Q2 = 2.*ev.dot(iq,iqbar);
+    value_type bw = 1./((Q2-_M_mB2)*(Q2-_M_mB2)+_M_mBgB2);
+
+    // matrix element squared
+    return bw * (
+      _M_cplus [f] * ev.dot(iq,1) * ev.dot(iqbar,2) +
+      _M_cminus[f] * ev.dot(iqbar,1) * ev.dot(iq,2)
+    );
+  }
+
 } // end of namespace school
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,209 @@
+/**
+ * \file
+ * \brief Implementation of miser_integral members.
+ */
+
+#include "miser-integral.h"
+#include "school-rng.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace school {
+
+  miser_integral::miser_integral(
+    value_type             Ecm ,
+    const qcd_hadron_base *pdf1,
+    const qcd_hadron_base *pdf2,
+    const matrix_element  *me  ,
+    const kinematic_cuts  *cuts
+  ) :
+  _M_integral            (Ecm, pdf1, pdf2, me, cuts),
+  _M_presample_fraction  (0.1),
+  _M_min_calls           (16*_M_integral.dimension()),
+  _M_bisection_factor    (32),
+  _M_estimate            (0.0),
+  _M_variance            (0.0),
+  _M_number_of_presamples(0),
+  _M_number_of_analysed  (0),
+  _TMP_u                 (_M_integral.dimension()) {
+  }
+
+  void miser_integral::set_parameters(
+    value_type presample_fraction,
+    size_type  min_calls_per_dimension,
+    size_type  bisection_factor
+  ) {
+    if (!(presample_fraction >= 0.0 && presample_fraction < 1.0)) {
+      throw std::invalid_argument("miser_integral: the presample fraction must be in [0,1)");
+    }
+    if (min_calls_per_dimension == 0 || bisection_factor == 0) {
+      throw std::invalid_argument("miser_integral: the minimal calls and the bisection factor must be positive");
+    }
+    _M_presample_fraction = presample_fraction;
+    _M_min_calls          = min_calls_per_dimension*_M_integral.dimension();
+    _M_bisection_factor   = bisection_factor;
+  }
+
+  miser_integral::value_type miser_integral::_M_sample(
+    const std::vector<value_type> & lower,
+    const std::vector<value_type> & upper,
+    event                         & ev
+  ) {
+    std::uniform_real_distribution<value_type> rng;
+    for (size_type d = 0; d < _TMP_u.size(); d++) {
+      // never exactly 0, generate_event() divides by xa*xb
+      do {
+        _TMP_u[d] = lower[d] + (upper[d] - lower[d])*rng(_G_random_engine);
+      } while (_TMP_u[d] <= 0.0);
+    }
+    return _M_integral.generate(ev, _TMP_u.data());
+  }
+
+  void miser_integral::_M_plan(
+    std::vector<value_type> & lower,
+    std::vector<value_type> & upper,
+    size_type                 n
+  ) {
+
+    const size_type dim = lower.size();
+
+    if (n < _M_min_calls*_M_bisection_factor) {
+      _M_leaves.push_back(leaf{lower, upper, n});
+      return;
+    }
+
+    //----- presample, with sums for the two halves of every dimension -----
+    size_type npre = static_cast<size_type>(_M_presample_fraction*n);
+    if (npre < _M_min_calls) { npre = _M_min_calls; }
+
+    std::vector<value_type> sum (2*dim, 0.0), sum2(2*dim, 0.0);
+    std::vector<size_type>  cnt (2*dim, 0);
+
+    for (size_type k = 0; k < npre; k++) {
+      value_type f = _M_sample(lower, upper, _TMP_event);
+      for (size_type d = 0; d < dim; d++) {
+        size_type h = 2*d + (_TMP_u[d] < 0.5*(lower[d] + upper[d]) ? 0 : 1);
+        sum [h] += f;
+        sum2[h] += f*f;
+        cnt [h] += 1;
+      }
+    }
+    _M_number_of_presamples += npre;
+
+    //----- the dimension with the smallest sum of sigma^beta -----
+    // With beta = 2/3 (alpha = 2 of Press and Farrar) the sharing is less
+    // extreme than the optimum for exact variances, which protects against
+    // a presample that missed the peak of a half.
+    const value_type beta = 2.0/3.0;
+
+    size_type  best = dim;
+    value_type best_sigma = std::numeric_limits<value_type>::max(), sigma_l = 0.0, sigma_r = 0.0;
+
+    for (size_type d = 0; d < dim; d++) {
+      if (cnt[2*d] < 2 || cnt[2*d+1] < 2) { continue; }
+      value_type s[2];
+      for (size_type h = 0; h < 2; h++) {
+        value_type mean = sum[2*d+h]/cnt[2*d+h];
+        s[h] = std::pow(std::max(0.0, sum2[2*d+h]/cnt[2*d+h] - mean*mean), 0.5*beta);
+      }
+      if (s[0] + s[1] < best_sigma) {
+        best_sigma = s[0] + s[1];
+        best       = d;
+        sigma_l    = s[0];
+        sigma_r    = s[1];
+      }
+    }
+
+    size_type rest = n - npre;
+
+    // no usable presample or too few events left for two halves, no split
+    if (best == dim || rest < 2*_M_min_calls) {
+      _M_leaves.push_back(leaf{lower, upper, rest});
+      return;
+    }
+
+    //----- share the events in proportion to sigma^beta -----
+    value_type frac = sigma_l + sigma_r > 0.0 ? sigma_l/(sigma_l + sigma_r) : 0.5;
+    size_type  nl   = static_cast<size_type>(frac*rest);
+    if (nl < _M_min_calls       ) { nl = _M_min_calls;        }
+    if (nl > rest - _M_min_calls) { nl = rest - _M_min_calls; }
+
+    value_type mid = 0.5*(lower[best] + upper[best]), edge;
+
+    edge = upper[best]; upper[best] = mid;
+    _M_plan(lower, upper, nl);
+    upper[best] = edge;
+
+    edge = lower[best]; lower[best] = mid;
+    _M_plan(lower, upper, rest - nl);
+    lower[best] = edge;
+  }
+
+  void miser_integral::operator () (size_type n, const std::vector<analyser*> & ah) {
+
+    const size_type dim        = _TMP_u.size();
+    const size_type block_size = 1024;
+
+    //----- plan -----
+    _M_leaves.clear();
+    _M_number_of_presamples = 0;
+
+    std::vector<value_type> lower(dim, 0.0), upper(dim, 1.0);
+    _M_plan(lower, upper, n);
+
+    size_type total = 0;
+    for (auto & l : _M_leaves) { total += l.n; }
+    _M_number_of_analysed = total;
+
+    //----- sample the leaves -----
+    std::vector<event>      events (block_size);
+    std::vector<value_type> weights(block_size);
+
+    _M_estimate = 0.0;
+    _M_variance = 0.0;
+
+    for (auto & l : _M_leaves) {
+      if (l.n == 0) { continue; }
+
+      value_type volume = 1.0;
+      for (size_type d = 0; d < dim; d++) { volume *= l.upper[d] - l.lower[d]; }
+
+      // the analysers average over all events
+      const value_type scale = volume*total/l.n;
+      value_type       s = 0.0, s2 = 0.0;
+
+      for (size_type done = 0; done < l.n; done += block_size) {
+        size_type m = l.n - done < block_size ? l.n - done : block_size;
+
+        for (size_type k = 0; k < m; k++) {
+          value_type f = _M_sample(l.lower, l.upper, events[k]);
+          s  += f;
+          s2 += f*f;
+          weights[k] = scale*f;
+        }
+
+        for (auto a : ah) {
+          a->operator()(events.data(), weights.data(), m);
+        }
+      }
+
+      value_type mean = s/l.n;
+      _M_estimate += volume*mean;
+      _M_variance += volume*volume*std::max(0.0, s2/l.n - mean*mean)/l.n;
+    }
+  }
+
+  miser_integral::value_type miser_integral::error() const {
+    return std::sqrt(_M_variance);
+  }
+
+  std::ostream & miser_integral::print(std::ostream & os) const {
+    return os << "MISER cross section is " << _M_estimate << " +/- " << error()
+              << " (" << _M_leaves.size() << " regions, "
+              << _M_number_of_analysed << " analysed and "
+              << _M_number_of_presamples << " presample events)" << std::endl;
+  }
+
+} // end of namespace school
@@ -0,0 +1,142 @@
+/**
+ * \file
+ * \brief Definition of the miser_integral class.
+ */
+
+#ifndef __SCHOOL_MISER_INTEGRAL_H__
+#define __SCHOOL_MISER_INTEGRAL_H__ 1
+
+#include "mc-integral.h"
+
+#include <iostream>
+#include <vector>
+
+namespace school {
+
+  /** \brief MC integral with recursive stratified sampling (MISER).
+   *
+   * The integrand is the event weight as a function of the dimension()
+   * uniform random numbers of an event (mc_integral::generate(ev, u)), over
+   * the unit hypercube. A region with too few events is a leaf and is
+   * sampled uniformly. A larger region spends a fraction of its events on a
+   * presample, splits at the middle of the dimension where the two halves
+   * have the smallest sum of sigma^(2/3), and shares the rest of its events
+   * between the halves in proportion to sigma^(2/3), as in GSL's MISER with
+   * alpha = 2 (sigma is the standard deviation of the weights in a half).
+   * The estimate is the sum of the leaf estimates, its variance the sum of
+   * the leaf variances.
+   *
+   * This is done in two phases. The plan phase runs the recursion with the
+   * presamples only and records the leaves with their number of events. The
+   * leaf phase samples the leaves and passes the events to the analysers.
+   * Since the total number of analysed events is known by then, every event
+   * gets the weight volume/n_leaf * n_total * f, so the plain average of the
+   * weights, as total_xsection and the histograms take it, is the
+   * stratified estimate. The presample events are not analysed.
+   */
+  class miser_integral {
+
+  public:
+
+    typedef event::value_type value_type;
+    typedef event::size_type  size_type;
+
+  private:
+
+    /** \brief A leaf: its box and its number of events.
+     */
+    struct leaf {
+      std::vector<value_type> lower, upper;
+      size_type               n;
+    };
+
+    mc_integral _M_integral;
+
+    /** \brief Fraction of the events of a region used in its presample.
+     */
+    value_type _M_presample_fraction;
+
+    /** \brief Smallest presample, and regions smaller than this times
+     * _M_bisection_factor are leaves.
+     */
+    size_type _M_min_calls;
+    size_type _M_bisection_factor;
+
+    std::vector<leaf> _M_leaves;
+
+    value_type _M_estimate, _M_variance;
+    size_type  _M_number_of_presamples, _M_number_of_analysed;
+
+    /** \brief Scratch space of the recursion.
+     */
+    event                   _TMP_event;
+    std::vector<value_type> _TMP_u;
+
+  public:
+
+    miser_integral(
+      value_type             Ecm ,
+      const qcd_hadron_base *pdf1,
+      const qcd_hadron_base *pdf2,
+      const matrix_element  *me  ,
+      const kinematic_cuts  *cuts = 0
+    );
+
+    /** \brief Set the tuning parameters: the presample fraction (0.1), the
+     * smallest presample per dimension (16) and the bisection factor (32).
+     *
+     * Throws std::invalid_argument unless 0 <= presample_fraction < 1 and
+     * the other two are positive.
+     */
+    void set_parameters(value_type presample_fraction, size_type min_calls_per_dimension, size_type bisection_factor);
+
+    /** \brief Integrate with about n events (presamples included).
+     */
+    void operator () (size_type n, const std::vector<analyser*> & ah);
+
+    value_type estimate() const {
+      return _M_estimate;
+    }
+
+    value_type error() const;
+
+    size_type number_of_leaves() const {
+      return _M_leaves.size();
+    }
+
+    size_type number_of_presamples() const {
+      return _M_number_of_presamples;
+    }
+
+    /** \brief Events passed to the analysers, the presamples are not.
+     */
+    size_type number_of_analysed() const {
+      return _M_number_of_analysed;
+    }
+
+    /** \brief Events rejected by the cuts, presamples included.
+     */
+    size_type number_of_rejected() const {
+      return _M_integral.number_of_rejected();
+    }
+
+    /** \brief Print the estimate, its error and the number of analysed
+     * events.
+     */
+    std::ostream & print(std::ostream &) const;
+
+  private:
+
+    /** \brief The plan phase for a region.
+     */
+    void _M_plan(std::vector<value_type> & lower, std::vector<value_type> & upper, size_type n);
+
+    /** \brief Weight at a uniform point of the box.
+     */
+    value_type _M_sample(const std::vector<value_type> & lower, const std::vector<value_type> & upper, event & ev);
+
+  }; // end of class miser_integral
+
+} // end of namespace school
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * \file
+ * \brief Implementation of parallel_integral members.
+ */
+
+#include "parallel-integral.h"
+#include "school-rng.h"
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace school {
+
+  // Everything a worker owns.
+  struct __parallel_worker {
+    int                                      cpu;  // -1 if not pinned
+    std::unique_ptr<mc_integral>             integral;
+    std::vector<std::unique_ptr<analyser> >  analysers;
+    std::vector<event>                       events;
+    std::vector<event::value_type>           weights;
+  };
+
+  void parallel_integral::operator () (
+    size_type                        n,
+    size_type                        block_size,
+    size_type                        threads,
+    const std::vector<analyser*> & ah,
+    unsigned long                    seed
+  ) {
+
+    if (block_size == 0) { block_size = 1; }
+
+    work_stealing_scheduler           scheduler(threads);
+    std::vector<__parallel_worker>    workers(scheduler.number_of_workers());
+    const std::vector<analyser*>      prototypes(ah);
+    const cpu_topology                topology;
+
+    // The workers pin themselves and make their own copies in their threads,
+    // so the pages are first touched on their own node.
+    auto start = [&] (size_type w) {
+      __parallel_worker & wk = workers[w];
+      wk.cpu = _M_affinity.cpu(topology, w);
+      if (wk.cpu >= 0 && !pin_this_thread(wk.cpu)) { wk.cpu = -1; }
+      wk.integral.reset(new mc_integral(_M_integral));
+      for (auto a : prototypes) {
+        wk.analysers.push_back(std::unique_ptr<analyser>(a->clone()));
+      }
+      wk.events .resize(block_size);
+      wk.weights.resize(block_size);
+    };
+
+    // Block b has the events b*block_size... and its own random stream.
+    auto task = [&] (size_type w, size_type b) {
+      __parallel_worker & wk = workers[w];
+      size_type           m  = n - b*block_size < block_size ? n - b*block_size : block_size;
+
+      seed_random_engine(seed, b);
+
+      for (size_type k = 0; k < m; k++) {
+        wk.weights[k] = wk.integral->generate(wk.events[k]);
+      }
+
+      for (auto & a : wk.analysers) {
+        a->operator()(wk.events.data(), wk.weights.data(), m);
+      }
+    };
+
+    scheduler.run((n + block_size - 1)/block_size, task, start);
+
+    _M_number_of_rejected = 0;
+    _M_number_of_steals   = scheduler.number_of_steals();
+
+    // Group the workers by node, unpinned workers count as node 0. The
+    // first worker of a node collects the results of the node.
+    std::vector<std::vector<size_type> > nodes(topology.number_of_nodes());
+    for (size_type w = 0; w < workers.size(); w++) {
+      _M_number_of_rejected += workers[w].integral->number_of_rejected();
+      nodes[workers[w].cpu >= 0 ? topology.node_of(workers[w].cpu) : 0].push_back(w);
+    }
+
+    auto merge_node = [&] (const std::vector<size_type> & node) {
+      __parallel_worker & leader = workers[node[0]];
+      if (leader.cpu >= 0) { pin_this_thread(leader.cpu); }
+      for (size_type k = 1; k < node.size(); k++) {
+        for (size_type i = 0; i < prototypes.size(); i++) {
+          leader.analysers[i]->merge(*workers[node[k]].analysers[i]);
+        }
+      }
+    };
+
+    std::vector<std::thread> mergers;
+    for (auto & node : nodes) {
+      if (node.size() > 1) { mergers.push_back(std::thread(merge_node, std::cref(node))); }
+    }
+    for (auto & t : mergers) { t.join(); }
+
+    // global merge, in node order
+    for (auto & node : nodes) {
+      if (node.empty()) { continue; }
+      for (size_type i = 0; i < prototypes.size(); i++) {
+        prototypes[i]->merge(*workers[node[0]].analysers[i]);
+      }
+    }
+  }
+
+} // end of namespace school
@@ -0,0 +1,106 @@
+/**
+ * \file
+ * \brief Definition of the parallel_integral class.
+ */
+
+#ifndef __SCHOOL_PARALLEL_INTEGRAL_H__
+#define __SCHOOL_PARALLEL_INTEGRAL_H__ 1
+
+#include "mc-integral.h"
+#include "work-stealing.h"
+#include "thread-affinity.h"
+
+#include <vector>
+
+namespace school {
+
+  /** \brief MC integral running on several threads.
+   *
+   * The events are cut into blocks, and the blocks are the tasks of a
+   * work_stealing_scheduler. The random engine is seeded per block with
+   * seed_random_engine(seed, block), so the events of a block do not depend
+   * on the thread that made them: the same seed and block size give the same
+   * event sample for any number of threads (the sums may differ in the last
+   * digits, because they are added in a different order). Every worker has
+   * its own clones of the analysers, which are merged into the given
+   * analysers at the end.
+   *
+   * The workers can be pinned to cores with an affinity_policy. A worker
+   * makes its copy of the integral, its analyser clones and its event buffers
+   * in its own thread after pinning, so the memory is first touched and
+   * placed on its own NUMA node. At the end the clones are merged node by
+   * node, by a thread on that node, and only the node results cross to the
+   * calling thread.
+   */
+  class parallel_integral {
+
+  public:
+
+    typedef event::value_type value_type;
+    typedef event::size_type  size_type;
+
+  private:
+
+    /** \brief The integral copied to every worker.
+     */
+    mc_integral _M_integral;
+
+    /** \brief How to pin the workers.
+     */
+    affinity_policy _M_affinity;
+
+    size_type _M_number_of_rejected;
+    size_type _M_number_of_steals;
+
+  public:
+
+    parallel_integral(
+      value_type             Ecm ,
+      const qcd_hadron_base *pdf1,
+      const qcd_hadron_base *pdf2,
+      const matrix_element  *me  ,
+      const kinematic_cuts  *cuts = 0
+    ) :
+    _M_integral          (Ecm, pdf1, pdf2, me, cuts),
+    _M_number_of_rejected(0),
+    _M_number_of_steals  (0) {
+    }
+
+    /** \brief Generate n events in blocks on the given number of threads
+     * and analyse them.
+     */
+    void operator () (
+      size_type                        n,
+      size_type                        block_size,
+      size_type                        threads,
+      const std::vector<analyser*> & ah,
+      unsigned long                    seed = 0
+    );
+
+    /** \brief Set the affinity policy of the workers.
+     */
+    void set_affinity(const affinity_policy & policy) {
+      _M_affinity = policy;
+    }
+
+    const affinity_policy & affinity() const {
+      return _M_affinity;
+    }
+
+    /** \brief Number of events rejected by the cuts in the last run.
+     */
+    size_type number_of_rejected() const {
+      return _M_number_of_rejected;
+    }
+
+    /** \brief Number of blocks stolen by idle workers in the last run.
+     */
+    size_type number_of_steals() const {
+      return _M_number_of_steals;
+    }
+
+  }; // end of class parallel_integral
+
+} // end of namespace school
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * \file
+ * \brief Implementation of perf_counters members.
+ */
+
+#include "perf-counters.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+
+namespace school {
+
+  static int __perf_event_open(std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // this thread, any cpu
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  perf_counters::perf_counters() {
+    static const std::uint64_t config[number_of_counters] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for (int c = 0; c < number_of_counters; c++) {
+      _M_fd   [c] = __perf_event_open(PERF_TYPE_HARDWARE, config[c]);
+      _M_start[c] = 0.0;
+      _M_total[c] = 0.0;
+      if (_M_fd[c] < 0 && _M_error.empty()) {
+        _M_error = std::string(name(static_cast<counter_type>(c))) + ": " + std::strerror(errno);
+      }
+    }
+  }
+
+  perf_counters::~perf_counters() {
+    for (int c = 0; c < number_of_counters; c++) {
+      if (_M_fd[c] >= 0) { close(_M_fd[c]); }
+    }
+  }
+
+  bool perf_counters::any_available() const {
+    for (int c = 0; c < number_of_counters; c++) {
+      if (_M_fd[c] >= 0) { return true; }
+    }
+    return false;
+  }
+
+  perf_counters::value_type perf_counters::_M_read(counter_type c) const {
+    if (_M_fd[c] < 0) { return 0.0; }
+
+    // value, time enabled, time running
+    std::uint64_t data[3];
+    if (read(_M_fd[c], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+      return 0.0;
+    }
+    return static_cast<value_type>(data[0])*data[1]/data[2];
+  }
+
+  void perf_counters::start() {
+    for (int c = 0; c < number_of_counters; c++) {
+      _M_start[c] = _M_read(static_cast<counter_type>(c));
+    }
+  }
+
+  void perf_counters::stop() {
+    for (int c = 0; c < number_of_counters; c++) {
+      _M_total[c] += _M_read(static_cast<counter_type>(c)) - _M_start[c];
+    }
+  }
+
+  const char * perf_counters::name(counter_type c) {
+    static const char * names[number_of_counters] = {
+      "cycles", "instructions", "cache-misses", "branch-misses"
+    };
+    return names[c];
+  }
+
+  std::ostream & perf_counters::print(std::ostream & os, const std::string & phase, size_type events) const {
+
+    os << "#   hardware counters: " << phase << std::endl;
+
+    if (!any_available()) {
+      return os << "# not available (" << _M_error << ")" << std::endl;
+    }
+
+    for (int c = 0; c < number_of_counters; c++) {
+      os << std::left << std::setw(16) << name(static_cast<counter_type>(c)) << std::right;
+      if (available(static_cast<counter_type>(c))) {
+        os << std::setw(16) << std::fixed << std::setprecision(0) << _M_total[c]
+           << std::setw(12) << std::setprecision(2) << (events ? _M_total[c]/events : 0.0)
+           << " per event" << std::defaultfloat << std::setprecision(6) << std::endl;
+      } else {
+        os << "  not available" << std::endl;
+      }
+    }
+
+    if (available(cycles) && available(instructions) && _M_total[cycles] > 0) {
+      os << "IPC             " << std::setw(16) << std::fixed << std::setprecision(3)
+         << _M_total[instructions]/_M_total[cycles]
+         << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+
+    return os;
+  }
+
+} // end of namespace school
@@ -0,0 +1,107 @@
+/**
+ * \file
+ * \brief Definition of the perf_counters class.
+ */
+
+#ifndef __SCHOOL_PERF_COUNTERS_H__
+#define __SCHOOL_PERF_COUNTERS_H__ 1
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace school {
+
+  /** \brief Hardware performance counters of the calling thread.
+   *
+   * Opens Linux perf events for cycles, instructions, cache misses and branch
+   * misses of the calling thread (user space only). The counters run from the
+   * construction on, start() and stop() add the counts in between to the
+   * totals, so one object can time a phase which is entered many times.
+   *
+   * Every counter is opened on its own, so a counter the hardware or the
+   * kernel does not give us (no PMU in a virtual machine, perf_event_paranoid,
+   * seccomp) is simply missing from the report. When the kernel multiplexes
+   * the counters the counts are scaled up by the enabled/running time.
+   */
+  class perf_counters {
+
+  public:
+
+    typedef std::size_t size_type;
+    typedef double      value_type;
+
+    enum counter_type { cycles, instructions, cache_misses, branch_misses, number_of_counters };
+
+  private:
+
+    /** \brief File descriptors of the events, -1 if not available.
+     */
+    int _M_fd[number_of_counters];
+
+    /** \brief Reason why the first unavailable counter could not be opened.
+     */
+    std::string _M_error;
+
+    /** \brief Counts at the last start().
+     */
+    value_type _M_start[number_of_counters];
+
+    /** \brief Sum of the counts between start() and stop().
+     */
+    value_type _M_total[number_of_counters];
+
+    /** \brief Current scaled count of a counter.
+     */
+    value_type _M_read(counter_type) const;
+
+  public:
+
+    perf_counters();
+   ~perf_counters();
+
+    perf_counters(const perf_counters &)               = delete;
+    perf_counters & operator = (const perf_counters &) = delete;
+
+    bool available(counter_type c) const {
+      return _M_fd[c] >= 0;
+    }
+
+    /** \brief True if at least one counter works.
+     */
+    bool any_available() const;
+
+    /** \brief Why some counters are missing, empty if all of them work.
+     */
+    const std::string & error() const {
+      return _M_error;
+    }
+
+    /** \brief Start a phase.
+     */
+    void start();
+
+    /** \brief End a phase and add its counts to the totals.
+     */
+    void stop();
+
+    /** \brief Total count of a counter.
+     */
+    value_type total(counter_type c) const {
+      return _M_total[c];
+    }
+
+    /** \brief Print the totals, the counts per event and the instructions
+     * per cycle.
+     */
+    std::ostream & print(std::ostream &, const std::string & phase, size_type events) const;
+
+    /** \brief Name of a counter.
+     */
+    static const char * name(counter_type);
+
+  }; // end of class perf_counters
+
+} // end of namespace school
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * \file
+ * \brief Implementation of analysis_pipeline members.
+ */
+
+#include "pipeline.h"
+#include "school-rng.h"
+
+#include <thread>
+
+namespace school {
+
+  void analysis_pipeline::run(
+    const std::vector<mc_integral *>             & generators,
+    size_type                                      n,
+    const std::vector<std::vector<analyser *> >  & consumers,
+    unsigned long                                  seed
+  ) {
+
+    // Without consumers the generators would fill the ring and wait forever.
+    if (generators.empty() || consumers.empty()) { return; }
+
+    // The consumers stop after the last ticket of this run.
+    const size_type limit = _M_ring.tickets_read() + n;
+
+    // events per generator, the last one takes the remainder
+    const size_type share = n/generators.size();
+    const size_type rest  = n - share*generators.size();
+
+    std::vector<std::thread> threads;
+
+    //----- generators -----
+    for (size_type g = 0; g < generators.size(); g++) {
+      const size_type m = g + 1 < generators.size() ? share : share + rest;
+      threads.push_back(std::thread([this, &generators, g, m, seed] () {
+        seed_random_engine(seed, g);
+        mc_integral & gen = *generators[g];
+        for (size_type k = 0; k < m; k++) {
+          size_type          ticket = _M_ring.acquire_write();
+          event_ring::slot & s      = _M_ring[ticket];
+          s.weight = gen.generate(s.ev);
+          _M_ring.publish(ticket);
+        }
+      }));
+    }
+
+    //----- consumers -----
+    for (size_type c = 0; c < consumers.size(); c++) {
+      threads.push_back(std::thread([this, &consumers, c, limit] () {
+        const std::vector<analyser *> & ah = consumers[c];
+        size_type ticket;
+        while (_M_ring.try_acquire_read(limit, ticket)) {
+          event_ring::slot & s = _M_ring[ticket];
+          for (auto iter : ah) {
+            iter->operator()(s.ev, s.weight);
+          }
+          _M_ring.release(ticket);
+        }
+      }));
+    }
+
+    for (auto & t : threads) {
+      t.join();
+    }
+  }
+
+} // end of namespace school
@@ -0,0 +1,65 @@
+/**
+ * \file
+ * \brief Definition of the analysis_pipeline class.
+ */
+
+#ifndef __SCHOOL_PIPELINE_H__
+#define __SCHOOL_PIPELINE_H__ 1
+
+#include "event-ring.h"
+#include "mc-integral.h"
+#include "analyser.h"
+
+#include <vector>
+
+namespace school {
+
+  /** \brief Generation and analysis in separate threads.
+   *
+   * Every generator runs in its own thread and writes its events directly
+   * into the slots of an event_ring. The consumer threads take the events
+   * from the ring and run their analysers on them, so a slow analyser does
+   * not stall the generation as long as the ring is not full. Each consumer
+   * has its own list of analysers and sees only the events it took from the
+   * ring. With one consumer (the usual case) the analysers see every event;
+   * with several consumers the results of their analysers have to be added.
+   */
+  class analysis_pipeline {
+
+  public:
+
+    typedef event::size_type  size_type;
+    typedef event::value_type value_type;
+
+  private:
+
+    /** \brief The ring between the generators and the consumers.
+     */
+    event_ring _M_ring;
+
+  public:
+
+    /** \brief Make a pipeline with a ring of the given capacity.
+     */
+    explicit analysis_pipeline(size_type capacity = 1024) : _M_ring(capacity) {
+    }
+
+    /** \brief Run the pipeline.
+     *
+     * The n events are shared out evenly among the generators, the last one
+     * makes the remainder, too. The random engine of generator thread g is
+     * seeded with seed_random_engine(seed, g). Without generators or
+     * consumers nothing is done.
+     */
+    void run(
+      const std::vector<mc_integral *>             & generators,
+      size_type                                      n,
+      const std::vector<std::vector<analyser *> >  & consumers,
+      unsigned long                                  seed = 0
+    );
+
+  }; // end of class analysis_pipeline
+
+} // end of namespace school
+
+#endif
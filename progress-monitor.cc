@@ -0,0 +1,125 @@
+/**
+ * \file
+ * \brief Implementation of progress_monitor members.
+ */
+
+#include "progress-monitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+namespace school {
+
+  progress_monitor::progress_monitor(
+    size_type           total,
+    double              interval,
+    std::ostream      * os,
+    const std::string & status_file,
+    size_type           publish_every
+  ) :
+  _M_publish_every        (publish_every > 0 ? publish_every : 1),
+  _M_events               (0),
+  _M_next_publish         (_M_publish_every),
+  _M_weight_sum           (0.0),
+  _M_weight2_sum          (0.0),
+  _M_sequence             (0),
+  _M_published_events     (0),
+  _M_published_weight_sum (0.0),
+  _M_published_weight2_sum(0.0),
+  _M_total                (total),
+  _M_interval             (interval),
+  _M_os                   (os),
+  _M_status_file          (status_file),
+  _M_start                (std::chrono::steady_clock::now()),
+  _M_stop                 (false) {
+  }
+
+  progress_monitor::~progress_monitor() {
+    if (_M_thread.joinable()) {
+      stop();
+    }
+  }
+
+  void progress_monitor::start() {
+    _M_start = std::chrono::steady_clock::now();
+    _M_stop  = false;
+    _M_thread = std::thread(&progress_monitor::_M_run, this);
+  }
+
+  void progress_monitor::stop() {
+    _M_publish();
+    {
+      std::lock_guard<std::mutex> guard(_M_mutex);
+      _M_stop = true;
+    }
+    _M_wake.notify_one();
+    if (_M_thread.joinable()) {
+      _M_thread.join();
+    }
+    _M_report();
+  }
+
+  progress_monitor::snapshot progress_monitor::read() const {
+    snapshot res;
+    std::uint64_t s0, s1;
+    do {
+      s0 = _M_sequence.load(std::memory_order_acquire);
+      res.events      = _M_published_events     .load(std::memory_order_relaxed);
+      res.weight_sum  = _M_published_weight_sum .load(std::memory_order_relaxed);
+      res.weight2_sum = _M_published_weight2_sum.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      s1 = _M_sequence.load(std::memory_order_relaxed);
+    } while ((s0 & 1) || s0 != s1);
+    return res;
+  }
+
+  void progress_monitor::_M_run() {
+    std::unique_lock<std::mutex> lock(_M_mutex);
+    while (!_M_wake.wait_for(lock, _M_interval, [this] { return _M_stop; })) {
+      lock.unlock();
+      _M_report();
+      lock.lock();
+    }
+  }
+
+  std::ostream & progress_monitor::print(std::ostream & os) const {
+    snapshot   s       = read();
+    double     elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - _M_start).count();
+    double     rate    = elapsed > 0.0 ? s.events/elapsed : 0.0;
+    double     n       = static_cast<double>(s.events);
+    value_type mean    = n > 0 ? s.weight_sum/n : 0.0;
+    value_type spread  = n > 0 ? std::sqrt(std::max(0.0, s.weight2_sum/n - mean*mean)) : 0.0;
+
+    os << "progress: " << s.events << "/" << _M_total << " events";
+    if (_M_total > 0) {
+      os << " (" << std::fixed << std::setprecision(1) << 100.0*s.events/_M_total << "%)";
+    }
+    os << std::defaultfloat << std::setprecision(4)
+       << ", " << rate << " events/s";
+    if (rate > 0.0 && s.events < _M_total) {
+      os << ", ETA " << (_M_total - s.events)/rate << " s";
+    }
+    // the same numbers as total_xsection prints, and the error of the mean
+    return os << ", xsection " << mean << " +/- " << spread << " (weight spread)"
+              << ", error of the mean " << (n > 1 ? spread/std::sqrt(n) : 0.0)
+              << std::setprecision(6) << std::endl;
+  }
+
+  void progress_monitor::_M_report() {
+    if (_M_os) {
+      print(*_M_os);
+    }
+    if (!_M_status_file.empty()) {
+      std::string tmp = _M_status_file + ".tmp";
+      {
+        std::ofstream file(tmp.c_str());
+        print(file);
+      }
+      std::rename(tmp.c_str(), _M_status_file.c_str());
+    }
+  }
+
+} // end of namespace school
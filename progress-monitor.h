@@ -0,0 +1,165 @@
+/**
+ * \file
+ * \brief Definition of the progress_monitor analyser.
+ */
+
+#ifndef __SCHOOL_PROGRESS_MONITOR_H__
+#define __SCHOOL_PROGRESS_MONITOR_H__ 1
+
+#include "analyser.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace school {
+
+  /** \brief Reports the progress of a run from a background thread.
+   *
+   * As an analyser it sums the weights like total_xsection. Every
+   * publish_every events it publishes the event count and the sums through a
+   * sequence lock: the event loop only does relaxed atomic stores, and it
+   * never waits for the reader. A reader that sees the sequence number change
+   * while it copies the values simply tries again.
+   *
+   * The monitor thread wakes up at every interval and prints the events so
+   * far, the rate, the estimated time to go and the running cross section.
+   * The cross section comes with the spread of the weights, which is what
+   * total_xsection prints after its "+/-", and with the error of the mean,
+   * which is the spread over the square root of the events. If a status
+   * file is given, it is rewritten at every interval through a temporary
+   * file and a rename, so a reader never sees a half-written file.
+   */
+  class progress_monitor : public analyser {
+
+  public:
+
+    /** \brief A consistent copy of the published values.
+     */
+    struct snapshot {
+      size_type  events;
+      value_type weight_sum;
+      value_type weight2_sum;
+    };
+
+  private:
+
+    //----- the event loop side -----
+
+    size_type  _M_publish_every;
+    size_type  _M_events;         // events seen by analyze()
+    size_type  _M_next_publish;   // publish when _M_events reaches this
+    value_type _M_weight_sum, _M_weight2_sum;
+
+    //----- the published values, behind the sequence lock -----
+
+    std::atomic<std::uint64_t> _M_sequence;
+    std::atomic<size_type>     _M_published_events;
+    std::atomic<value_type>    _M_published_weight_sum;
+    std::atomic<value_type>    _M_published_weight2_sum;
+
+    //----- the monitor thread -----
+
+    size_type                             _M_total;
+    std::chrono::duration<double>         _M_interval;
+    std::ostream                        * _M_os;
+    std::string                           _M_status_file;
+    std::chrono::steady_clock::time_point _M_start;
+    std::thread                           _M_thread;
+    std::mutex                            _M_mutex;
+    std::condition_variable               _M_wake;
+    bool                                  _M_stop;
+
+  public:
+
+    /** \brief Monitor of a run of total events, reporting to os (may be
+     * null) and to the status file (if not empty) every interval seconds.
+     */
+    progress_monitor(
+      size_type           total,
+      double              interval      = 10.0,
+      std::ostream      * os            = &std::cerr,
+      const std::string & status_file   = std::string(),
+      size_type           publish_every = 1024
+    );
+
+    progress_monitor(const progress_monitor &)               = delete;
+    progress_monitor & operator = (const progress_monitor &) = delete;
+
+    /** \brief Stops the thread.
+     */
+    ~progress_monitor();
+
+    /** \brief Analyze an event.
+     */
+    void analyze(const event &, value_type weight) {
+      _M_weight_sum  += weight;
+      _M_weight2_sum += weight*weight;
+      if (++_M_events == _M_next_publish) {
+        _M_publish();
+      }
+    }
+
+    /** \brief Analyze a block of events, published at once.
+     */
+    void analyze_batch(const event *, const value_type * weights, size_type n) {
+      for (size_type i = 0; i < n; i++) {
+        _M_weight_sum  += weights[i];
+        _M_weight2_sum += weights[i]*weights[i];
+      }
+      _M_events += n;
+      if (_M_events >= _M_next_publish) {
+        _M_publish();
+      }
+    }
+
+    /** \brief Start the monitor thread.
+     */
+    void start();
+
+    /** \brief Publish the last events, write the last report and stop the
+     * monitor thread.
+     */
+    void stop();
+
+    /** \brief Read the published values, lock free.
+     */
+    snapshot read() const;
+
+    /** \brief Print the progress line.
+     */
+    std::ostream & print(std::ostream &) const;
+
+  private:
+
+    /** \brief Publish the current values.
+     */
+    void _M_publish() {
+      std::uint64_t s = _M_sequence.load(std::memory_order_relaxed);
+      _M_sequence.store(s + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      _M_published_events     .store(_M_events, std::memory_order_relaxed);
+      _M_published_weight_sum .store(_M_weight_sum,  std::memory_order_relaxed);
+      _M_published_weight2_sum.store(_M_weight2_sum, std::memory_order_relaxed);
+      _M_sequence.store(s + 2, std::memory_order_release);
+      _M_next_publish = _M_events + _M_publish_every;
+    }
+
+    /** \brief Body of the monitor thread.
+     */
+    void _M_run();
+
+    /** \brief Write one report.
+     */
+    void _M_report();
+
+  }; // end of class progress_monitor
+
+} // end of namespace school
+
+#endif
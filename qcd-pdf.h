@@ -136,6 +136,66 @@ namespace school {
 
   }; // end of class qcd_antihadron
 
+  /** \brief Anti-hadron adaptor for a known hadron type.
+   *
+   * Same as qcd_antihadron, but the hadron type is a template parameter and
+   * the hadron is called with a qualified name. If the antihadron itself is
+   * called through its own type (as mc_integral_t does), both calls can be
+   * inlined. The same scope restriction applies as for qcd_antihadron.
+   */
+  template <class Hadron>
+  class qcd_antihadron_t : public qcd_hadron_base {
+
+  private:
+
+    /** \brief The original hadron.
+     */
+    const Hadron & _M_pdf;
+
+  public:
+
+    // It is impossible to create an antihadron without having an actual hadron.
+    qcd_antihadron_t() = delete;
+
+    /** \brief Constructing an antihadron from an existing hadron.
+     */
+    explicit qcd_antihadron_t(const Hadron & pdf) : _M_pdf(pdf) {
+    }
+
+    qcd_antihadron_t(const qcd_antihadron_t &) = default;
+
+    qcd_antihadron_t & operator = (const qcd_antihadron_t &) = delete;
+
+    //----- destructor -----
+    virtual ~qcd_antihadron_t() {
+    }
+
+    /** \brief The pdf function.
+     */
+    virtual value_type parton(flavor_type fl, value_type x, value_type q2) const {
+      return _M_pdf.Hadron::parton(-fl, x, q2);
+    }
+
+    /** \brief Lower bound for the pdf evolution range.
+     */
+    virtual value_type q2min() const {
+      return _M_pdf.Hadron::q2min();
+    }
+
+    /** \brief Upper bound for the pdf evolution range.
+     */
+    virtual value_type q2max() const {
+      return _M_pdf.Hadron::q2max();
+    }
+
+    /** \brief The smallest x value.
+     */
+    virtual value_type xmin() const {
+      return _M_pdf.Hadron::xmin();
+    }
+
+  }; // end of class qcd_antihadron_t
+
 } // end of namespace school
 
 #endif
\ No newline at end of file
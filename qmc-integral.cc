@@ -0,0 +1,78 @@
+/**
+ * \file
+ * \brief Implementation of qmc_integral members.
+ */
+
+#include "qmc-integral.h"
+#include "school-rng.h"
+
+#include <cmath>
+
+namespace school {
+
+  void qmc_integral::operator () (
+    size_type                        n,
+    size_type                        replicas,
+    const std::vector<analyser*> & ah,
+    unsigned long                    seed
+  ) {
+
+    const size_type block_size = 1024;
+
+    if (replicas == 0) { replicas = 1; }
+
+    sobol_sequence          sobol(_M_integral.dimension());
+    std::vector<value_type> u(sobol.dimension());
+    std::vector<event>      events (block_size);
+    std::vector<value_type> weights(block_size);
+
+    _M_estimates.clear();
+    _M_points = n;
+
+    for (size_type r = 0; r < replicas; r++) {
+
+      seed_random_engine(seed, r);
+      sobol.scramble(_G_random_engine);
+
+      value_type sum = 0.0;
+
+      for (size_type done = 0; done < n; done += block_size) {
+        size_type m = n - done < block_size ? n - done : block_size;
+
+        for (size_type k = 0; k < m; k++) {
+          sobol.next(u.data());
+          weights[k] = _M_integral.generate(events[k], u.data());
+          sum       += weights[k];
+        }
+
+        for (auto a : ah) {
+          a->operator()(events.data(), weights.data(), m);
+        }
+      }
+
+      _M_estimates.push_back(n > 0 ? sum/n : 0.0);
+    }
+  }
+
+  qmc_integral::value_type qmc_integral::estimate() const {
+    value_type sum = 0.0;
+    for (auto x : _M_estimates) { sum += x; }
+    return _M_estimates.empty() ? 0.0 : sum/_M_estimates.size();
+  }
+
+  qmc_integral::value_type qmc_integral::error() const {
+    const size_type r = _M_estimates.size();
+    if (r < 2) { return 0.0; }
+
+    value_type mean = estimate(), sum2 = 0.0;
+    for (auto x : _M_estimates) { sum2 += (x - mean)*(x - mean); }
+    return std::sqrt(sum2/(r*(r - 1)));
+  }
+
+  std::ostream & qmc_integral::print(std::ostream & os) const {
+    return os << "QMC cross section is " << estimate() << " +/- " << error()
+              << " (" << _M_estimates.size() << " replicas of " << _M_points << " points)"
+              << std::endl;
+  }
+
+} // end of namespace school
@@ -0,0 +1,96 @@
+/**
+ * \file
+ * \brief Definition of the qmc_integral class.
+ */
+
+#ifndef __SCHOOL_QMC_INTEGRAL_H__
+#define __SCHOOL_QMC_INTEGRAL_H__ 1
+
+#include "mc-integral.h"
+#include "sobol.h"
+
+#include <iostream>
+#include <vector>
+
+namespace school {
+
+  /** \brief Quasi Monte Carlo integral with scrambled Sobol points.
+   *
+   * Every event takes one point of a Sobol sequence with the dimension of the
+   * event (mc_integral::dimension(): the flavors, xa, xb and 4 numbers per
+   * outgoing particle) instead of numbers from _G_random_engine. The
+   * integral is repeated for a number of replicas with independent
+   * scramblings of the sequence. Each replica is an unbiased estimate, so the
+   * spread of the replica estimates gives the error; the usual error of
+   * total_xsection, made for independent points, does not apply here.
+   *
+   * All events of all replicas are passed to the analysers.
+   */
+  class qmc_integral {
+
+  public:
+
+    typedef event::value_type value_type;
+    typedef event::size_type  size_type;
+
+  private:
+
+    mc_integral _M_integral;
+
+    /** \brief The estimate of every replica.
+     */
+    std::vector<value_type> _M_estimates;
+
+    /** \brief Points per replica in the last run.
+     */
+    size_type _M_points;
+
+  public:
+
+    qmc_integral(
+      value_type             Ecm ,
+      const qcd_hadron_base *pdf1,
+      const qcd_hadron_base *pdf2,
+      const matrix_element  *me  ,
+      const kinematic_cuts  *cuts = 0
+    ) :
+    _M_integral(Ecm, pdf1, pdf2, me, cuts),
+    _M_points  (0) {
+    }
+
+    /** \brief Integrate with the given number of replicas of n points each
+     * (preferably a power of 2), the scramblings are drawn from
+     * seed_random_engine(seed, replica).
+     */
+    void operator () (
+      size_type                        n,
+      size_type                        replicas,
+      const std::vector<analyser*> & ah,
+      unsigned long                    seed = 0
+    );
+
+    /** \brief Mean of the replica estimates.
+     */
+    value_type estimate() const;
+
+    /** \brief Error of the mean of the replica estimates.
+     */
+    value_type error() const;
+
+    const std::vector<value_type> & replica_estimates() const {
+      return _M_estimates;
+    }
+
+    size_type number_of_rejected() const {
+      return _M_integral.number_of_rejected();
+    }
+
+    /** \brief Print the estimate and its error.
+     */
+    std::ostream & print(std::ostream &) const;
+
+  }; // end of class qmc_integral
+
+} // end of namespace school
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * \file
+ * \brief Implementation of quantile_sketch class methods.
+ */
+
+#include "quantile-sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace school {
+
+  quantile_sketch::quantile_sketch(size_type compression) :
+  _M_compression (compression),
+  _M_buffer_limit(8*compression),
+  _M_total       (0.0),
+  _M_min         ( std::numeric_limits<value_type>::infinity()),
+  _M_max         (-std::numeric_limits<value_type>::infinity()) {
+
+    // The merge leaves at most compression+1 centroids, so nothing
+    // is allocated after this. Copies do not keep the capacity, they
+    // allocate while they grow to the same sizes.
+    _M_centroids.reserve(2*compression + 1);
+    _M_buffer   .reserve(_M_buffer_limit);
+    _M_merged   .reserve(2*compression + 1 + _M_buffer_limit);
+  }
+
+  // Largest cumulative weight a centroid starting at the cumulative weight
+  // left may reach, one unit of the scale function further.
+  static quantile_sketch::value_type __quantile_sketch_limit(
+    quantile_sketch::value_type left,
+    quantile_sketch::value_type total,
+    quantile_sketch::size_type  compression
+  ) {
+    const quantile_sketch::value_type pi = 3.14159265358979323846;
+    quantile_sketch::value_type q = std::min(1.0, left/total);
+    quantile_sketch::value_type a = std::asin(2.0*q - 1.0) + 2.0*pi/compression;
+    return a >= 0.5*pi ? total : 0.5*(std::sin(a) + 1.0)*total;
+  }
+
+  void quantile_sketch::_M_compress() {
+
+    if (_M_buffer.empty()) { return; }
+
+    // all centroids together, sorted by their mean
+    _M_merged.assign(_M_centroids.begin(), _M_centroids.end());
+    _M_merged.insert(_M_merged.end(), _M_buffer.begin(), _M_buffer.end());
+    std::sort(_M_merged.begin(), _M_merged.end());
+
+    _M_buffer.clear();
+    _M_centroids.clear();
+
+    // Merge the neighbours while a centroid spans at most one unit of the
+    // scale k(q) = compression/(2 pi) asin(2q-1). The scale is steep at
+    // q = 0 and q = 1, so the centroids get small in the tails, and it spans
+    // compression/2 units, so there are at most compression+1 centroids.
+    value_type left  = 0.0; // weight before the current centroid
+    value_type limit = __quantile_sketch_limit(left, _M_total, _M_compression);
+    centroid   c     = _M_merged.front();
+
+    for (auto p = _M_merged.begin() + 1; p != _M_merged.end(); ++p) {
+      if (left + c.second + p->second <= limit) {
+        c.first   = (c.first*c.second + p->first*p->second) / (c.second + p->second);
+        c.second += p->second;
+      } else {
+        _M_centroids.push_back(c);
+        left += c.second;
+        limit = __quantile_sketch_limit(left, _M_total, _M_compression);
+        c = *p;
+      }
+    }
+
+    _M_centroids.push_back(c);
+  }
+
+  quantile_sketch::value_type quantile_sketch::quantile(value_type q) {
+
+    _M_compress();
+
+    if (_M_centroids.empty()) { return 0.0; }
+    if (q <= 0.0) { return _M_min; }
+    if (q >= 1.0) { return _M_max; }
+
+    // The weight of a centroid is spread around its mean, so the cumulative
+    // weight at the mean of centroid i is the sum before it plus its half.
+    // We interpolate linearly between these points and the extremes.
+    value_type target = q*_M_total;
+    value_type cum    = 0.0;
+    value_type x0     = _M_min;
+    value_type c0     = 0.0;
+
+    for (auto & c : _M_centroids) {
+      value_type c1 = cum + 0.5*c.second;
+      if (target < c1) {
+        return x0 + (c.first - x0)*(target - c0)/(c1 - c0);
+      }
+      cum += c.second;
+      x0   = c.first;
+      c0   = c1;
+    }
+
+    return x0 + (_M_max - x0)*(target - c0)/(_M_total - c0);
+  }
+
+  std::vector<quantile_sketch::value_type> quantile_sketch::equal_weight_edges(size_type n) {
+
+    std::vector<value_type> res;
+
+    res.push_back(_M_min);
+
+    for (size_type k = 1; k < n; ++k) {
+      value_type x = quantile(static_cast<value_type>(k)/n);
+      // edges must increase strictly
+      if (x > res.back()) { res.push_back(x); }
+    }
+
+    // the largest value belongs to the last bin
+    value_type top = _M_max + 1e-12*(std::abs(_M_max) + 1.0);
+    if (top > res.back()) { res.push_back(top); }
+
+    return res;
+  }
+
+} // end of namespace school
@@ -0,0 +1,99 @@
+/**
+ * \file
+ * \brief Definition of the quantile_sketch class.
+ */
+
+#ifndef __SCHOOL_QUANTILE_SKETCH_H__
+#define __SCHOOL_QUANTILE_SKETCH_H__ 1
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace school {
+
+  /** \brief Streaming sketch of a weighted distribution.
+   *
+   * The values are collected in a fixed size buffer. When it is full, the
+   * buffer is sorted into the list of centroids (mean, weight) and the
+   * neighbouring centroids are merged as long as they span at most one unit
+   * of the scale function k(q) = compression/(2 pi) asin(2q-1), q being the
+   * cumulative weight fraction. The scale is steep near q = 0 and q = 1, so
+   * the centroids hold a fraction of about 1/compression of the weight in the
+   * middle and much less in the tails, which keeps the extreme quantiles
+   * precise. The memory is bounded by the compression.
+   */
+  class quantile_sketch {
+
+  public:
+
+    typedef std::size_t size_type;
+    typedef double      value_type;
+
+  private:
+
+    /** \brief A centroid: weighted mean and sum of weights. */
+    typedef std::pair<value_type, value_type> centroid;
+
+    /** \brief Number of centroids we aim for. */
+    size_type _M_compression;
+
+    /** \brief Number of buffered values that triggers a merge. */
+    size_type _M_buffer_limit;
+
+    /** \brief The merged centroids, sorted by their mean. */
+    std::vector<centroid> _M_centroids;
+
+    /** \brief Values not merged yet. */
+    std::vector<centroid> _M_buffer;
+
+    /** \brief Scratch space of the merge. */
+    std::vector<centroid> _M_merged;
+
+    value_type _M_total; ///< sum of weights
+    value_type _M_min;   ///< smallest value
+    value_type _M_max;   ///< largest value
+
+  public:
+
+    /** \brief Construct a sketch with about compression centroids.
+     */
+    explicit quantile_sketch(size_type compression = 200);
+
+    /** \brief Add a value with a positive weight.
+     */
+    void add(value_type x, value_type weight) {
+      if (!(weight > 0.0)) { return; }
+      if (_M_buffer.size() >= _M_buffer_limit) { _M_compress(); }
+      _M_buffer.push_back(centroid(x, weight));
+      _M_total += weight;
+      if (x < _M_min) { _M_min = x; }
+      if (x > _M_max) { _M_max = x; }
+    }
+
+    /** \brief Sum of the weights seen so far.
+     */
+    value_type total() const {
+      return _M_total;
+    }
+
+    /** \brief The value below which the fraction q of the weight lies.
+     */
+    value_type quantile(value_type q);
+
+    /** \brief Edges of n bins with equal weight, from the smallest to the
+     * largest value seen.
+     */
+    std::vector<value_type> equal_weight_edges(size_type n);
+
+  private:
+
+    /** \brief Merge the buffer into the centroids.
+     */
+    void _M_compress();
+
+  }; // end of class quantile_sketch
+
+} // end of namespace school
+
+#endif
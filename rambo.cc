@@ -7,16 +7,26 @@
 
 namespace school {
 
+  static lorentzvector __rambo_helper_momentum(const event::value_type * u) {
+
+    event::value_type E   = -std::log(u[0]*u[1]);
+    event::value_type pz  = E*(2.0*u[2] - 1.0);
+    event::value_type pt  = std::sqrt(E*E - pz*pz);
+    event::value_type phi = 6.28318530717958647692*u[3];
+
+    return lorentzvector(pt*std::cos(phi), pt*std::sin(phi), pz, E);
+  }
+
   static lorentzvector __rambo_helper_random_momentum() {
 
     std::uniform_real_distribution<event::value_type> rng;
 
-    event::value_type E   = -std::log(rng(_G_random_engine)*rng(_G_random_engine));
-    event::value_type pz  = E*(2.0*rng(_G_random_engine) - 1.0);
-    event::value_type pt  = std::sqrt(E*E - pz*pz);
-    event::value_type phi = 6.28318530717958647692*rng(_G_random_engine);
+    event::value_type u[4];
+    for (auto & x : u) {
+      x = rng(_G_random_engine);
+    }
 
-    return lorentzvector(pt*std::cos(phi), pt*std::sin(phi), pz, E);
+    return __rambo_helper_momentum(u);
   }
 
   /** This function calculates the phase space weights for the RAMBO events.
@@ -61,6 +71,30 @@ namespace school {
     return std::pow(s/(__16PI2*fact[n]), (static_cast<int>(n)-2)/__8PI);
   }
 
+  // The conform transformation of the massless momenta in [first, last) to
+  // total momentum (sqrt(s), 0, 0, 0), and the weight.
+  static event::value_type __rambo_helper_transform(
+    event::value_type   s,
+    event::iterator     first,
+    event::iterator     last,
+    const lorentzvector & psum
+  ) {
+
+    //----- parameters of the conform transformation -----
+
+    event::value_type x    = std::sqrt(s)/std::sqrt(psum.mag2());
+    threevector       bVec = -psum.boostVector();
+
+    //----- do the conform transformation -----
+
+    for (auto iter = first; iter < last; iter++) {
+      iter->momentum.boost(bVec);
+      iter->momentum *= x;
+    }
+
+    return __rambo_helper_weight(static_cast<event::size_type>(last-first), s);
+  }
+
   event::value_type rambo(
     event::value_type s,
     event::iterator   first,
@@ -73,19 +107,23 @@ namespace school {
       psum += (iter->momentum = __rambo_helper_random_momentum());
     }
 
-    //----- parameters of the conform transformation -----
+    return __rambo_helper_transform(s, first, last, psum);
+  }
 
-    event::value_type x    = std::sqrt(s)/std::sqrt(psum.mag2());
-    threevector       bVec = -psum.boostVector();
+  event::value_type rambo(
+    event::value_type         s,
+    event::iterator           first,
+    event::iterator           last,
+    const event::value_type * u
+  ) {
 
-    //----- do the conform transformation -----
+    lorentzvector psum;
 
-    for (auto iter = first; iter < last; iter++) {
-      iter->momentum.boost(bVec);
-      iter->momentum *= x;
+    for (auto iter = first; iter < last; iter++, u += 4) {
+      psum += (iter->momentum = __rambo_helper_momentum(u));
     }
 
-    return __rambo_helper_weight(static_cast<event::size_type>(last-first), s);
+    return __rambo_helper_transform(s, first, last, psum);
   }
 
 } // end of namespace school
\ No newline at end of file
@@ -17,6 +17,16 @@ namespace school {
     event::iterator   last
   );
 
+  /** \brief Same as rambo(), with the uniform random numbers given in u,
+   * 4 for every particle, instead of taken from _G_random_engine.
+   */
+  event::value_type rambo(
+    event::value_type         s,
+    event::iterator           first,
+    event::iterator           last,
+    const event::value_type * u
+  );
+
 } // end of namespace school
 
 #endif
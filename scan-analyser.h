@@ -0,0 +1,145 @@
+/**
+ * \file
+ * \brief Definition of analysers for parameter scans.
+ */
+
+#ifndef __SCHOOL_SCAN_ANALYSER_H__
+#define __SCHOOL_SCAN_ANALYSER_H__ 1
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "analyser.h"
+#include "me-pp-to-llbar-scan.h"
+
+namespace school {
+
+  /** \brief Analyser base class for parameter scans.
+   *
+   * Same as analyser, but every event comes with one weight per grid point.
+   */
+  struct scan_analyser
+  {
+    typedef event::size_type  size_type;
+    typedef event::value_type value_type;
+
+    /** \brief Counter for the number of events.
+     */
+    size_type _M_number_of_events;
+
+    /** \brief The default constructor sets the number of events to zero.
+     */
+    scan_analyser() : _M_number_of_events(0) {
+    }
+
+    // destructor
+    virtual ~scan_analyser() {
+    }
+
+    /** \brief Analyze an event with the weights of all grid points.
+     */
+    virtual void analyze(const event & ev, const value_type * weights) = 0;
+
+    /** \brief Analyze an event and increment the counter.
+     */
+    void operator () (const event & ev, const value_type * weights)  {
+      this->analyze(ev, weights);
+      ++_M_number_of_events;
+    }
+
+    /** \brief Print the result.
+     */
+    virtual std::ostream & print(std::ostream &) const = 0;
+
+  }; // end of struct scan_analyser
+
+  /** \brief Total cross section for every grid point.
+   */
+  struct total_xsection_scan : scan_analyser {
+
+    /** \brief The scan, it gives the number of points and their parameters.
+     */
+    const me_pp_to_llbar_scan & _M_me;
+
+    /** \brief The sums of weights and weight squares per grid point.
+     */
+    std::vector<value_type> _M_weight_sum, _M_weight2_sum;
+
+    explicit total_xsection_scan(const me_pp_to_llbar_scan & me) :
+    _M_me         (me),
+    _M_weight_sum (me.size(), 0.0),
+    _M_weight2_sum(me.size(), 0.0) {
+    }
+
+    virtual ~total_xsection_scan() {
+    }
+
+    /** \brief Analyze an event.
+     */
+    void analyze(const event & ev, const value_type * weights) {
+      for (size_type k = 0; k < _M_weight_sum.size(); k++) {
+        _M_weight_sum [k] += weights[k];
+        _M_weight2_sum[k] += weights[k]*weights[k];
+      }
+    }
+
+    /** \brief Print the result, one line per grid point.
+     */
+    std::ostream & print(std::ostream & os) const {
+      os << "#   total cross section scan: mB  gB  xsec  error" << std::endl;
+      for (size_type k = 0; k < _M_weight_sum.size(); k++) {
+        os << _M_me.model(k).mB                          << "  "
+           << _M_me.model(k).gB                          << "  "
+           << _M_weight_sum[k]/_M_number_of_events       << "  "
+           << std::sqrt(
+                (_M_weight2_sum[k] -
+                 _M_weight_sum[k] * _M_weight_sum[k] / _M_number_of_events
+                ) / _M_number_of_events
+              )
+           << std::endl;
+      }
+      return os;
+    }
+
+  }; // end of struct total_xsection_scan
+
+  /** \brief Run an ordinary analyser on one grid point of a scan.
+   *
+   * The analyser is kept by reference and receives the weight of grid point
+   * k, so any analyser (pT_dist, ...) can be used in a scan.
+   */
+  struct scan_point : scan_analyser {
+
+    size_type  _M_point;
+    analyser & _M_analyser;
+
+    scan_point(size_type k, analyser & ana) : _M_point(k), _M_analyser(ana) {
+    }
+
+    virtual ~scan_point() {
+    }
+
+    /** \brief Analyze an event.
+     */
+    void analyze(const event & ev, const value_type * weights) {
+      _M_analyser(ev, weights[_M_point]);
+    }
+
+    /** \brief Print the result.
+     */
+    std::ostream & print(std::ostream & os) const {
+      return _M_analyser.print(os);
+    }
+
+  }; // end of struct scan_point
+
+} // end of namespace school
+
+/** \brief Print operator for all scan_analyser descendants.
+ */
+inline std::ostream & operator << (std::ostream & os, const school::scan_analyser & ana) {
+  return ana.print(os);
+}
+
+#endif
@@ -15,6 +15,14 @@ namespace school {
    *  pass through this information. We use mt19937_64 as defult generator in
    *  the school namespace. This can be changed if it is needed...
    */
-  std::mt19937_64 _G_random_engine;
+  thread_local std::mt19937_64 _G_random_engine;
+
+  void seed_random_engine(unsigned long seed, unsigned long stream) {
+    std::seed_seq seq{
+      static_cast<unsigned>(seed),   static_cast<unsigned>(seed   >> 32),
+      static_cast<unsigned>(stream), static_cast<unsigned>(stream >> 32)
+    };
+    _G_random_engine.seed(seq);
+  }
 
 } // end of namespace school
\ No newline at end of file
@@ -18,8 +18,19 @@ namespace school {
    *  generator that every routine can use so that we don't have to always
    *  pass through this information. We use mt19937_64 as defult generator in
    *  the school namespace. This can be changed if it is needed...
+   *
+   *  Every thread has its own engine, so threads can generate events
+   *  without locking. Each of them starts from the default seed, so threads
+   *  have to be given distinct streams with seed_random_engine().
    */
-  extern std::mt19937_64 _G_random_engine;
+  extern thread_local std::mt19937_64 _G_random_engine;
+
+  /** \brief Seed the engine of the calling thread.
+   *
+   *  Different (seed, stream) pairs give statistically independent
+   *  sequences, the same pair always gives the same sequence.
+   */
+  void seed_random_engine(unsigned long seed, unsigned long stream);
 
 } // end of namespace school
 
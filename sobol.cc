@@ -0,0 +1,131 @@
+/**
+ * \file
+ * \brief Implementation of sobol_sequence members.
+ */
+
+#include "sobol.h"
+
+#include <stdexcept>
+
+namespace school {
+
+  /** Primitive polynomials and initial direction numbers of dimensions 2..16
+   *  from new-joe-kuo-6.21201: degree s, coefficients a, m_1..m_s.
+   */
+  static const struct {
+    unsigned s, a, m[6];
+  } __sobol_joe_kuo[sobol_sequence::max_dimension - 1] = {
+    {1,  0, {1}},
+    {2,  1, {1, 3}},
+    {3,  1, {1, 3, 1}},
+    {3,  2, {1, 1, 1}},
+    {4,  1, {1, 1, 3, 3}},
+    {4,  4, {1, 3, 5, 13}},
+    {5,  2, {1, 1, 5, 5, 17}},
+    {5,  4, {1, 1, 5, 5, 5}},
+    {5,  7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6,  1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}}
+  };
+
+  // parity of the set bits
+  static inline sobol_sequence::word_type __parity(sobol_sequence::word_type x) {
+    return static_cast<sobol_sequence::word_type>(__builtin_parity(x));
+  }
+
+  sobol_sequence::sobol_sequence(size_type dimension) :
+  _M_dimension(dimension),
+  _M_base     (dimension*bits),
+  _M_shift    (dimension, 0),
+  _M_state    (dimension, 0),
+  _M_index    (0) {
+
+    if (dimension == 0 || dimension > max_dimension) {
+      throw std::invalid_argument("sobol_sequence: unsupported dimension");
+    }
+
+    // first dimension: van der Corput
+    for (size_type k = 0; k < bits; k++) {
+      _M_base[k] = word_type(1) << (bits - 1 - k);
+    }
+
+    for (size_type d = 1; d < dimension; d++) {
+      word_type     * v = &_M_base[d*bits];
+      const unsigned  s = __sobol_joe_kuo[d-1].s;
+      const unsigned  a = __sobol_joe_kuo[d-1].a;
+
+      for (size_type k = 0; k < s; k++) {
+        v[k] = word_type(__sobol_joe_kuo[d-1].m[k]) << (bits - 1 - k);
+      }
+
+      for (size_type k = s; k < bits; k++) {
+        v[k] = v[k-s] ^ (v[k-s] >> s);
+        for (unsigned i = 1; i < s; i++) {
+          if ((a >> (s - 1 - i)) & 1) { v[k] ^= v[k-i]; }
+        }
+      }
+    }
+
+    _M_direction = _M_base;
+  }
+
+  void sobol_sequence::scramble(std::mt19937_64 & engine) {
+
+    std::uniform_int_distribution<word_type> rng;
+
+    for (size_type d = 0; d < _M_dimension; d++) {
+
+      // Lower triangular matrix with unit diagonal, row i gives digit i
+      // (digit 0 is the most significant bit) from the digits 0..i.
+      word_type row[bits];
+      for (size_type i = 0; i < bits; i++) {
+        word_type higher = i > 0 ? ~((word_type(1) << (bits - i)) - 1) : 0;
+        row[i] = (word_type(1) << (bits - 1 - i)) | (rng(engine) & higher);
+      }
+
+      for (size_type k = 0; k < bits; k++) {
+        word_type v = _M_base[d*bits + k], res = 0;
+        for (size_type i = 0; i < bits; i++) {
+          res |= __parity(row[i] & v) << (bits - 1 - i);
+        }
+        _M_direction[d*bits + k] = res;
+      }
+
+      _M_shift[d] = rng(engine);
+    }
+
+    reset();
+  }
+
+  void sobol_sequence::reset() {
+    for (auto & x : _M_state) { x = 0; }
+    _M_index = 0;
+  }
+
+  void sobol_sequence::next(value_type * u) {
+
+    if (_M_index >> bits) {
+      throw std::length_error("sobol_sequence: more than 2^32 points");
+    }
+
+    for (size_type d = 0; d < _M_dimension; d++) {
+      u[d] = ((_M_state[d] ^ _M_shift[d]) + 0.5)*(1.0/4294967296.0);
+    }
+
+    // Gray code: the next point differs in the direction number of the
+    // lowest zero bit of the index.
+    size_type c = static_cast<size_type>(__builtin_ctzll(~_M_index));
+    if (c < bits) {
+      for (size_type d = 0; d < _M_dimension; d++) {
+        _M_state[d] ^= _M_direction[d*bits + c];
+      }
+    }
+
+    ++_M_index;
+  }
+
+} // end of namespace school
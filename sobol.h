@@ -0,0 +1,99 @@
+/**
+ * \file
+ * \brief Definition of the sobol_sequence class.
+ */
+
+#ifndef __SCHOOL_SOBOL_H__
+#define __SCHOOL_SOBOL_H__ 1
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace school {
+
+  /** \brief Sobol low discrepancy sequence in up to 16 dimensions.
+   *
+   * The direction numbers are the ones of Joe and Kuo (new-joe-kuo-6.21201),
+   * the points are generated in Gray code order with 32 bit integers, one
+   * XOR per dimension and point.
+   *
+   * A plain Sobol sequence is deterministic and gives no error estimate.
+   * scramble() applies a random linear matrix scrambling (Matousek) and a
+   * random digital shift, this keeps the low discrepancy of the points, makes
+   * every point uniformly distributed, and independent scramblings give
+   * independent replicas of the estimate. The balance properties hold for the
+   * first 2^m points, so runs of a power of 2 points are the best.
+   */
+  class sobol_sequence {
+
+  public:
+
+    typedef std::size_t   size_type;
+    typedef double        value_type;
+    typedef std::uint32_t word_type;
+
+    /** \brief Highest supported dimension.
+     */
+    static const size_type max_dimension = 16;
+
+    /** \brief Number of bits of the points.
+     */
+    static const size_type bits = 32;
+
+  private:
+
+    size_type _M_dimension;
+
+    /** \brief Unscrambled direction numbers, bits of them per dimension.
+     */
+    std::vector<word_type> _M_base;
+
+    /** \brief Direction numbers in use, bits of them per dimension.
+     */
+    std::vector<word_type> _M_direction;
+
+    /** \brief Digital shift of every dimension.
+     */
+    std::vector<word_type> _M_shift;
+
+    /** \brief The next point, without the shift.
+     */
+    std::vector<word_type> _M_state;
+
+    /** \brief Number of points generated.
+     */
+    std::uint64_t _M_index;
+
+  public:
+
+    /** \brief Unscrambled sequence of the given dimension. Throws
+     * std::invalid_argument if the dimension is not supported.
+     */
+    explicit sobol_sequence(size_type dimension);
+
+    size_type dimension() const {
+      return _M_dimension;
+    }
+
+    /** \brief Restart with a new random scrambling.
+     */
+    void scramble(std::mt19937_64 & engine);
+
+    /** \brief Restart the sequence.
+     */
+    void reset();
+
+    /** \brief The next point, dimension() numbers in (0,1).
+     *
+     * The numbers are centred in their 2^-32 cell, so they are never 0.
+     * Throws std::length_error after 2^32 points.
+     */
+    void next(value_type * u);
+
+  }; // end of class sobol_sequence
+
+} // end of namespace school
+
+#endif
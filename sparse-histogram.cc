@@ -0,0 +1,100 @@
+/**
+ * \file
+ * \brief Implementation of sparse_histogram class methods.
+ */
+
+#include "sparse-histogram.h"
+
+#include <cmath>
+
+namespace school {
+
+  sparse_histogram::sparse_histogram(const sparse_histogram & h) :
+  _M_name           (h._M_name),
+  _M_axis           (h._M_axis),
+  _M_pages          (h._M_pages.size()),
+  _M_number_of_pages(0) {
+    *this = h;
+  }
+
+  sparse_histogram & sparse_histogram::operator = (const sparse_histogram & h) {
+
+    if (this == &h) { return *this; }
+
+    _M_name = h._M_name;
+    _M_axis = h._M_axis;
+    _M_pages.clear();
+    _M_pages.resize(h._M_pages.size());
+    _M_number_of_pages = 0;
+
+    // copy only the allocated pages
+    for (size_type p = 0; p < h._M_pages.size(); p++) {
+      if (!h._M_pages[p]) { continue; }
+      _M_new_page(_M_pages[p]);
+      for (size_type k = 0; k < page_size; k++) {
+        _M_pages[p][k] = h._M_pages[p][k];
+      }
+    }
+
+    return *this;
+  }
+
+  void sparse_histogram::_M_new_page(std::unique_ptr<bin[]> & page) {
+    page.reset(new bin[page_size]);
+    ++_M_number_of_pages;
+  }
+
+  void sparse_histogram::_M_print_bin(
+    std::ostream  & os,
+    size_type       k,
+    const bin     * b,
+    unsigned long   npoints
+  ) const {
+
+    value_type lo = _M_axis.lower(k);
+    value_type hi = _M_axis.upper(k);
+    value_type dx = hi - lo;
+    value_type w  = b ? b->sum_of_weights         : 0.0;
+    value_type w2 = b ? b->sum_of_squared_weights : 0.0;
+
+    os << lo                  << "  "
+       << hi                  << "  "
+       << w/npoints/dx        << "  "
+       << std::sqrt((w2 - w * w / npoints) / npoints) / dx
+       << std::endl;
+  }
+
+  std::ostream & sparse_histogram::print(std::ostream & os, unsigned long npoints) const {
+
+    // print the name
+    os << "#   " << _M_name << std::endl;
+
+    // print the filled bins of the allocated pages
+    for (size_type p = 0; p < _M_pages.size(); p++) {
+      if (!_M_pages[p]) { continue; }
+      for (size_type k = p*page_size; k < size() && k < (p+1)*page_size; k++) {
+        const bin & b = _M_pages[p][k % page_size];
+        if (b.sum_of_squared_weights != 0.0) {
+          _M_print_bin(os, k, &b, npoints);
+        }
+      }
+    }
+
+    return os;
+  }
+
+  std::ostream & sparse_histogram::print_dense(std::ostream & os, unsigned long npoints) const {
+
+    // print the name
+    os << "#   " << _M_name << std::endl;
+
+    // print every bin
+    for (size_type k = 0; k < size(); k++) {
+      const std::unique_ptr<bin[]> & page = _M_pages[k / page_size];
+      _M_print_bin(os, k, page ? &page[k % page_size] : 0, npoints);
+    }
+
+    return os;
+  }
+
+} // end of namespace school
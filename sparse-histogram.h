@@ -0,0 +1,124 @@
+/**
+ * \file
+ * \brief Definition of the sparse_histogram class.
+ */
+
+#ifndef __SCHOOL_SPARSE_HISTOGRAM_H__
+#define __SCHOOL_SPARSE_HISTOGRAM_H__ 1
+
+#include "histogram-nd.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace school {
+
+  /** \brief One dimensional histogram for very fine binnings.
+   *
+   * The bins are stored in pages of page_size bins. A page is allocated at
+   * the first fill of one of its bins, so only the regions of the axis that
+   * are actually populated cost memory. Finding the bin is the same O(1)
+   * lookup as in histogram_nd plus one page table access.
+   */
+  class sparse_histogram {
+
+  public:
+
+    typedef histogram::size_type  size_type;
+    typedef histogram::value_type value_type;
+    typedef histogram::bin        bin;
+
+    /** \brief Number of bins in a page.
+     */
+    static const size_type page_size = 1024;
+
+  private:
+
+    /** \brief Name of the analysis.
+     */
+    std::string _M_name;
+
+    /** \brief The binning.
+     */
+    axis _M_axis;
+
+    /** \brief The page table, null for pages without any fill.
+     */
+    std::vector<std::unique_ptr<bin[]> > _M_pages;
+
+    /** \brief Number of allocated pages.
+     */
+    size_type _M_number_of_pages;
+
+  public:
+
+    /** There is no analysis without a name and a binning. */
+    sparse_histogram() = delete;
+
+    sparse_histogram(const sparse_histogram &);
+    sparse_histogram & operator = (const sparse_histogram &);
+    ~sparse_histogram() = default;
+
+    /** Construct giving name and binning. */
+    sparse_histogram(const std::string & name, const axis & a) :
+    _M_name           (name),
+    _M_axis           (a),
+    _M_pages          ((a.size() + page_size - 1) / page_size),
+    _M_number_of_pages(0) {
+    }
+
+    /** \brief Number of bins.
+     */
+    size_type size() const {
+      return _M_axis.size();
+    }
+
+    /** \brief Memory used by the bins and the page table in bytes.
+     */
+    size_type memory() const {
+      return _M_number_of_pages*page_size*sizeof(bin) + _M_pages.size()*sizeof(_M_pages[0]);
+    }
+
+    /** \brief Accumulate weights into the histogram.
+     */
+    void accumulate(value_type observable, value_type weight) {
+
+      size_type k;
+
+      // do nothing if the observable is outside of the axis
+      if (!_M_axis.index(observable, k)) { return; }
+
+      // get the page, make it at the first fill
+      std::unique_ptr<bin[]> & page = _M_pages[k / page_size];
+      if (!page) { _M_new_page(page); }
+
+      // fill the weight
+      page[k % page_size].count(weight);
+    }
+
+    /** \brief Print the bins that have been filled.
+     *
+     * The format is the same as histogram::print(), but empty bins are
+     * skipped.
+     */
+    std::ostream & print(std::ostream &, unsigned long) const;
+
+    /** \brief Print every bin, including the empty ones.
+     */
+    std::ostream & print_dense(std::ostream &, unsigned long) const;
+
+  private:
+
+    void _M_new_page(std::unique_ptr<bin[]> &);
+
+    /** \brief Print one bin, b is null for an empty bin.
+     */
+    void _M_print_bin(std::ostream &, size_type, const bin *, unsigned long) const;
+
+  }; // end of class sparse_histogram
+
+} // end of namespace school
+
+#endif
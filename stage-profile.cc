@@ -0,0 +1,42 @@
+/**
+ * \file
+ * \brief Implementation of stage_profile members.
+ */
+
+#include "stage-profile.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace school {
+
+  void stage_profile::clear() {
+    for (auto & t : _M_ticks) { t = 0; }
+    for (auto & c : _M_calls) { c = 0; }
+  }
+
+  std::ostream & stage_profile::print(std::ostream & os) const {
+
+    tick_type total = 0;
+    for (auto t : _M_ticks) { total += t; }
+
+    os << "#   time per stage in " << unit() << std::endl
+       << "# stage                     ticks        calls   ticks/call       %" << std::endl;
+
+    for (size_type k = 0; k < _M_ticks.size(); k++) {
+      std::ostringstream name;
+      if (k < _M_names.size()) { name << _M_names[k]; } else { name << _M_extra_name << ' ' << k - _M_names.size(); }
+
+      os << std::left  << std::setw(20) << name.str() << std::right
+         << std::setw(18) << _M_ticks[k]
+         << std::setw(13) << _M_calls[k]
+         << std::setw(13) << std::fixed << std::setprecision(1)
+         << (_M_calls[k] ? double(_M_ticks[k])/_M_calls[k] : 0.0)
+         << std::setw(8)  << (total ? 100.0*_M_ticks[k]/total : 0.0)
+         << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+
+    return os;
+  }
+
+} // end of namespace school
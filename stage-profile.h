@@ -0,0 +1,133 @@
+/**
+ * \file
+ * \brief Definition of the stage_profile class and the instrumentation macros.
+ */
+
+#ifndef __SCHOOL_STAGE_PROFILE_H__
+#define __SCHOOL_STAGE_PROFILE_H__ 1
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace school {
+
+  /** \brief Time and number of calls of the stages of a loop.
+   *
+   * The time is counted in ticks of the time stamp counter on x86, in
+   * nanoseconds of the steady clock elsewhere. Reading the time stamp counter
+   * costs some tens of cycles, so the overhead is a few percent of an event.
+   */
+  class stage_profile {
+
+  public:
+
+    typedef std::uint64_t tick_type;
+    typedef std::size_t   size_type;
+
+  private:
+
+    std::vector<std::string> _M_names;
+    std::string              _M_extra_name; // prefix of the unnamed stages
+    std::vector<tick_type>   _M_ticks;
+    std::vector<tick_type>   _M_calls;
+
+  public:
+
+    /** \brief Profile of the stages with the given names. The stages after
+     * them are called extra_name 0, extra_name 1, ...
+     */
+    explicit stage_profile(
+      const std::vector<std::string> & names      = std::vector<std::string>(),
+      const std::string              & extra_name = "stage"
+    ) :
+    _M_names     (names),
+    _M_extra_name(extra_name),
+    _M_ticks(names.size(), 0),
+    _M_calls(names.size(), 0) {
+    }
+
+    /** \brief The current time in ticks.
+     */
+    static tick_type now() {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /** \brief Unit of the ticks.
+     */
+    static const char * unit() {
+#if defined(__x86_64__) || defined(__i386__)
+      return "TSC ticks";
+#else
+      return "ns";
+#endif
+    }
+
+    /** \brief Count a call of a stage which started at time t, and set t to
+     * the current time, so consecutive stages can be timed with one clock
+     * reading each. Stages beyond the named ones are added on the fly.
+     */
+    void lap(size_type stage, tick_type & t) {
+      tick_type t1 = now();
+      if (stage >= _M_ticks.size()) {
+        _M_ticks.resize(stage+1, 0);
+        _M_calls.resize(stage+1, 0);
+      }
+      _M_ticks[stage] += t1 - t;
+      _M_calls[stage] += 1;
+      t = t1;
+    }
+
+    size_type size() const {
+      return _M_ticks.size();
+    }
+
+    tick_type ticks(size_type stage) const {
+      return _M_ticks[stage];
+    }
+
+    tick_type calls(size_type stage) const {
+      return _M_calls[stage];
+    }
+
+    /** \brief Set every counter to zero.
+     */
+    void clear();
+
+    /** \brief Print the ticks, the calls, the ticks per call and the
+     * fraction of the total time of every stage.
+     */
+    std::ostream & print(std::ostream &) const;
+
+  }; // end of class stage_profile
+
+} // end of namespace school
+
+/** \brief Instrumentation macros, compiled away unless SCHOOL_INSTRUMENT is
+ * defined.
+ *
+ * SCHOOL_PROFILE_START(t) reads the clock into a new variable t, and
+ * SCHOOL_PROFILE_LAP(profile, stage, t) counts the time since t for the
+ * stage and restarts t.
+ */
+#ifdef SCHOOL_INSTRUMENT
+#define SCHOOL_PROFILE_START(t)             school::stage_profile::tick_type t = school::stage_profile::now()
+#define SCHOOL_PROFILE_LAP(profile, stage, t) (profile).lap((stage), t)
+#else
+#define SCHOOL_PROFILE_START(t)             do {} while (0)
+#define SCHOOL_PROFILE_LAP(profile, stage, t) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * \file
+ * \brief Implementation of thread affinity functions.
+ */
+
+#include "thread-affinity.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace school {
+
+  // Parse a kernel cpu list like "0-3,8,10-11".
+  static std::vector<int> __parse_cpu_list(const std::string & text) {
+    std::vector<int>   cpus;
+    std::istringstream in(text);
+    std::string        item;
+
+    while (std::getline(in, item, ',')) {
+      if (item.empty() || item == "\n") { continue; }
+      char * end;
+      long   first = std::strtol(item.c_str(), &end, 10), last = first;
+      if (end == item.c_str()) {
+        throw std::invalid_argument("bad cpu list: " + text);
+      }
+      if (*end == '-') {
+        const char * start = end + 1;
+        last = std::strtol(start, &end, 10);
+        if (end == start) {
+          throw std::invalid_argument("bad cpu list: " + text);
+        }
+      }
+      for (long c = first; c <= last; c++) {
+        cpus.push_back(static_cast<int>(c));
+      }
+    }
+    return cpus;
+  }
+
+  cpu_topology::cpu_topology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+      CPU_SET(0, &allowed);
+    }
+
+    for (int node = 0; ; node++) {
+      std::ostringstream path;
+      path << "/sys/devices/system/node/node" << node << "/cpulist";
+      std::ifstream file(path.str().c_str());
+      if (!file) { break; }
+
+      std::string line;
+      std::getline(file, line);
+
+      std::vector<int> cpus;
+      for (int c : __parse_cpu_list(line)) {
+        if (c < CPU_SETSIZE && CPU_ISSET(c, &allowed)) {
+          cpus.push_back(c);
+          CPU_CLR(c, &allowed);
+        }
+      }
+      if (!cpus.empty()) { _M_nodes.push_back(cpus); }
+    }
+
+    // cores not found in any node go to a node of their own
+    std::vector<int> rest;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+      if (CPU_ISSET(c, &allowed)) { rest.push_back(c); }
+    }
+    if (!rest.empty()) { _M_nodes.push_back(rest); }
+  }
+
+  cpu_topology::size_type cpu_topology::number_of_cpus() const {
+    size_type n = 0;
+    for (auto & node : _M_nodes) { n += node.size(); }
+    return n;
+  }
+
+  cpu_topology::size_type cpu_topology::node_of(int cpu) const {
+    for (size_type node = 0; node < _M_nodes.size(); node++) {
+      for (int c : _M_nodes[node]) {
+        if (c == cpu) { return node; }
+      }
+    }
+    return 0;
+  }
+
+  affinity_policy affinity_policy::parse(const std::string & text) {
+    if (text == "none"   ) { return affinity_policy(none   ); }
+    if (text == "compact") { return affinity_policy(compact); }
+    if (text == "scatter") { return affinity_policy(scatter); }
+
+    affinity_policy policy(explicit_list);
+    policy.cpu_list = __parse_cpu_list(text);
+    if (policy.cpu_list.empty()) {
+      throw std::invalid_argument("bad affinity policy: " + text);
+    }
+    return policy;
+  }
+
+  int affinity_policy::cpu(const cpu_topology & topology, std::size_t w) const {
+    switch (kind) {
+    case compact: {
+      w %= topology.number_of_cpus();
+      for (std::size_t node = 0; ; node++) {
+        if (w < topology.cpus(node).size()) { return topology.cpus(node)[w]; }
+        w -= topology.cpus(node).size();
+      }
+    }
+    case scatter: {
+      // worker w goes to core w/nodes of node w%nodes
+      std::size_t nn = topology.number_of_nodes();
+      const std::vector<int> & cpus = topology.cpus(w % nn);
+      return cpus[(w / nn) % cpus.size()];
+    }
+    case explicit_list:
+      return cpu_list[w % cpu_list.size()];
+    default:
+      return -1;
+    }
+  }
+
+  bool pin_this_thread(int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) { return false; }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+  }
+
+} // end of namespace school
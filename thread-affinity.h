@@ -0,0 +1,93 @@
+/**
+ * \file
+ * \brief Pinning threads to cores and the NUMA layout of the machine.
+ */
+
+#ifndef __SCHOOL_THREAD_AFFINITY_H__
+#define __SCHOOL_THREAD_AFFINITY_H__ 1
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace school {
+
+  /** \brief The cores we may run on, grouped by NUMA node.
+   *
+   * The nodes are read from /sys/devices/system/node, and only the cores in
+   * the affinity mask of the process are kept. Without NUMA information all
+   * cores are put in one node.
+   */
+  class cpu_topology {
+
+  public:
+
+    typedef std::size_t size_type;
+
+  private:
+
+    /** \brief Cores of every node, empty nodes are dropped.
+     */
+    std::vector<std::vector<int> > _M_nodes;
+
+  public:
+
+    /** \brief Topology of the machine we are running on.
+     */
+    cpu_topology();
+
+    size_type number_of_nodes() const {
+      return _M_nodes.size();
+    }
+
+    const std::vector<int> & cpus(size_type node) const {
+      return _M_nodes[node];
+    }
+
+    /** \brief Total number of usable cores.
+     */
+    size_type number_of_cpus() const;
+
+    /** \brief Node of a core, 0 if we do not know the core.
+     */
+    size_type node_of(int cpu) const;
+
+  }; // end of class cpu_topology
+
+  /** \brief Which core a worker thread is pinned to.
+   *
+   *  - none:     threads are not pinned,
+   *  - compact:  worker w goes to the w-th core, filling one node before the
+   *              next one,
+   *  - scatter:  consecutive workers go to different nodes, in turn,
+   *  - explicit: worker w goes to the w-th core of a given list.
+   *
+   * More workers than cores wrap around.
+   */
+  struct affinity_policy {
+
+    enum kind_type { none, compact, scatter, explicit_list };
+
+    kind_type        kind;
+    std::vector<int> cpu_list; // only for explicit_list
+
+    affinity_policy(kind_type k = none) : kind(k) {}
+
+    /** \brief Read a policy from "none", "compact", "scatter" or a comma
+     * separated list of cores like "0,2,4-7". Throws std::invalid_argument.
+     */
+    static affinity_policy parse(const std::string & text);
+
+    /** \brief Core of worker w, -1 if it is not pinned.
+     */
+    int cpu(const cpu_topology & topology, std::size_t w) const;
+
+  }; // end of struct affinity_policy
+
+  /** \brief Pin the calling thread to a core, false if it did not work.
+   */
+  bool pin_this_thread(int cpu);
+
+} // end of namespace school
+
+#endif
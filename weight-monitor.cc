@@ -0,0 +1,216 @@
+/**
+ * \file
+ * \brief Implementation of weight_monitor members.
+ */
+
+#include "weight-monitor.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace school {
+
+  typedef std::pair<weight_monitor::value_type, weight_monitor::size_type> __top_entry;
+
+  weight_monitor::weight_monitor(value_type w_min, value_type w_max, size_type n_bins, size_type k) :
+  _M_axis               (axis::logarithmic(w_min, w_max, n_bins)),
+  _M_counts             (n_bins + 2, 0),
+  _M_sums               (n_bins + 2, 0.0),
+  _M_number_of_zeros    (0),
+  _M_number_of_negatives(0),
+  _M_weight_sum         (0.0),
+  _M_weight2_sum        (0.0),
+  _M_k                  (k > 0 ? k : 1),
+  _M_top_weights        (_M_k, 0.0),
+  _M_top_events         (_M_k) {
+    _M_top.reserve(_M_k);
+  }
+
+  void weight_monitor::_M_insert_top(const event & ev, value_type weight) {
+
+    size_type slot;
+
+    if (_M_top.size() < _M_k) {
+      slot = _M_top.size();
+    } else {
+      // drop the smallest, its slot is reused
+      std::pop_heap(_M_top.begin(), _M_top.end(), std::greater<__top_entry>());
+      slot = _M_top.back().second;
+      _M_top.pop_back();
+    }
+
+    _M_top_weights[slot] = weight;
+    _M_top_events [slot] = ev;
+
+    _M_top.push_back(__top_entry(std::fabs(weight), slot));
+    std::push_heap(_M_top.begin(), _M_top.end(), std::greater<__top_entry>());
+  }
+
+  weight_monitor::value_type weight_monitor::maximum_weight() const {
+    value_type res = 0.0;
+    for (auto & t : _M_top) {
+      res = std::max(res, t.first);
+    }
+    return res;
+  }
+
+  weight_monitor::value_type weight_monitor::unweighting_efficiency(size_type n) const {
+    std::vector<value_type> w;
+    for (auto & t : _M_top) {
+      w.push_back(t.first);
+    }
+    std::sort(w.begin(), w.end(), std::greater<value_type>());
+
+    if (n == 0 || n > w.size() || _M_number_of_events == 0) { return 0.0; }
+    return std::fabs(_M_weight_sum)/_M_number_of_events/w[n-1];
+  }
+
+  std::vector<std::pair<weight_monitor::value_type, const event *> > weight_monitor::top() const {
+    std::vector<__top_entry> sorted(_M_top);
+    std::sort(sorted.begin(), sorted.end(), std::greater<__top_entry>());
+
+    std::vector<std::pair<value_type, const event *> > res;
+    for (auto & t : sorted) {
+      res.push_back(std::make_pair(_M_top_weights[t.second], &_M_top_events[t.second]));
+    }
+    return res;
+  }
+
+  weight_monitor * weight_monitor::clone() const {
+    return new weight_monitor(_M_axis.lower(0), _M_axis.upper(_M_axis.size()-1), _M_axis.size(), _M_k);
+  }
+
+  void weight_monitor::merge_results(const analyser & ana) {
+    const weight_monitor & b = dynamic_cast<const weight_monitor &>(ana);
+
+    for (size_type k = 0; k < _M_counts.size() && k < b._M_counts.size(); k++) {
+      _M_counts[k] += b._M_counts[k];
+      _M_sums  [k] += b._M_sums  [k];
+    }
+
+    _M_number_of_zeros     += b._M_number_of_zeros;
+    _M_number_of_negatives += b._M_number_of_negatives;
+    _M_weight_sum          += b._M_weight_sum;
+    _M_weight2_sum         += b._M_weight2_sum;
+
+    for (auto & t : b._M_top) {
+      if (_M_top.size() < _M_k || t.first > _M_top.front().first) {
+        _M_insert_top(b._M_top_events[t.second], b._M_top_weights[t.second]);
+      }
+    }
+  }
+
+  // Doubles of a serialized top event: weight, xa, xb, number of particles,
+  // then flavor and momentum of every particle.
+  static const weight_monitor::size_type __top_record_size = 4 + 5*weight_monitor::max_stored_particles;
+
+  weight_monitor::size_type weight_monitor::results_size() const {
+    return 2*_M_counts.size() + 5 + _M_k*__top_record_size;
+  }
+
+  void weight_monitor::store_results(value_type * out) const {
+
+    for (auto c : _M_counts) { *out++ = static_cast<value_type>(c); }
+    for (auto w : _M_sums  ) { *out++ = w; }
+
+    *out++ = static_cast<value_type>(_M_number_of_zeros);
+    *out++ = static_cast<value_type>(_M_number_of_negatives);
+    *out++ = _M_weight_sum;
+    *out++ = _M_weight2_sum;
+    *out++ = static_cast<value_type>(_M_top.size());
+
+    for (auto & t : _M_top) {
+      const event & ev = _M_top_events[t.second];
+      const size_type np = ev.number_of_outgoings() + 2;
+
+      if (np > max_stored_particles) {
+        throw std::logic_error("weight_monitor: too many particles to serialize a top event");
+      }
+
+      value_type * rec = out;
+      *rec++ = _M_top_weights[t.second];
+      *rec++ = ev.xa;
+      *rec++ = ev.xb;
+      *rec++ = static_cast<value_type>(np);
+      for (auto & p : ev) {
+        *rec++ = static_cast<value_type>(static_cast<int>(p.flavor));
+        *rec++ = p.momentum.X();
+        *rec++ = p.momentum.Y();
+        *rec++ = p.momentum.Z();
+        *rec++ = p.momentum.T();
+      }
+      out += __top_record_size;
+    }
+
+    // the unused records are zero
+    std::fill(out, out + (_M_k - _M_top.size())*__top_record_size, 0.0);
+  }
+
+  void weight_monitor::add_results(const value_type * in) {
+
+    for (auto & c : _M_counts) { c += static_cast<size_type>(*in++); }
+    for (auto & w : _M_sums  ) { w += *in++; }
+
+    _M_number_of_zeros     += static_cast<size_type>(*in++);
+    _M_number_of_negatives += static_cast<size_type>(*in++);
+    _M_weight_sum          += *in++;
+    _M_weight2_sum         += *in++;
+
+    const size_type ntop = static_cast<size_type>(*in++);
+    event           ev;
+
+    for (size_type i = 0; i < ntop; i++, in += __top_record_size) {
+      const value_type * rec = in;
+      value_type weight = *rec++;
+
+      if (_M_top.size() == _M_k && std::fabs(weight) <= _M_top.front().first) { continue; }
+
+      ev.xa = *rec++;
+      ev.xb = *rec++;
+      ev.resize(static_cast<size_type>(*rec++) - 2);
+      for (auto & p : ev) {
+        p.flavor   = static_cast<flavor_type>(static_cast<int>(*rec++));
+        p.momentum = lorentzvector(rec[0], rec[1], rec[2], rec[3]);
+        rec += 4;
+      }
+      _M_insert_top(ev, weight);
+    }
+  }
+
+  std::ostream & weight_monitor::print(std::ostream & os) const {
+
+    const value_type n = static_cast<value_type>(_M_number_of_events);
+
+    os << "#   weight distribution" << std::endl
+       << "# events " << _M_number_of_events
+       << ", zero weights " << _M_number_of_zeros
+       << ", negative weights " << _M_number_of_negatives << std::endl
+       << "# effective sample size " << effective_sample_size()
+       << " (" << (n > 0 ? effective_sample_size()/n : 0.0) << " of the events)" << std::endl
+       << "# maximum weight " << maximum_weight()
+       << ", unweighting efficiency " << unweighting_efficiency(1)
+       << " (" << unweighting_efficiency(_M_top.size()) << " against the "
+       << _M_top.size() << "th largest weight)" << std::endl;
+
+    // the log bins: lower and upper edge, events, fraction of the cross section
+    os << "# |w| from  to  events  fraction of sum w" << std::endl;
+    os << 0.0 << "  " << _M_axis.lower(0) << "  " << _M_counts[_M_axis.size()] << "  "
+       << (_M_weight_sum != 0.0 ? _M_sums[_M_axis.size()]/_M_weight_sum : 0.0) << std::endl;
+    for (size_type k = 0; k < _M_axis.size(); k++) {
+      os << _M_axis.lower(k) << "  " << _M_axis.upper(k) << "  " << _M_counts[k] << "  "
+         << (_M_weight_sum != 0.0 ? _M_sums[k]/_M_weight_sum : 0.0) << std::endl;
+    }
+    os << _M_axis.upper(_M_axis.size()-1) << "  inf  " << _M_counts[_M_axis.size()+1] << "  "
+       << (_M_weight_sum != 0.0 ? _M_sums[_M_axis.size()+1]/_M_weight_sum : 0.0) << std::endl;
+
+    // the top weights with their events
+    os << "# largest weights" << std::endl;
+    for (auto & t : top()) {
+      os << "# weight " << t.first << std::endl << *t.second;
+    }
+
+    return os;
+  }
+
+} // end of namespace school
@@ -0,0 +1,179 @@
+/**
+ * \file
+ * \brief Definition of the weight_monitor analyser.
+ */
+
+#ifndef __SCHOOL_WEIGHT_MONITOR_H__
+#define __SCHOOL_WEIGHT_MONITOR_H__ 1
+
+#include "analyser.h"
+#include "histogram-nd.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace school {
+
+  /** \brief Analyser of the weight distribution.
+   *
+   * Tells how efficient the sampling is:
+   *
+   *  - the number of events and the sum of weights in logarithmic bins of
+   *    |weight|, events with zero weight (cut away) and negative weights are
+   *    counted apart,
+   *  - the k largest weights together with copies of their events,
+   *  - the effective sample size (sum w)^2/(sum w^2), the number of
+   *    unit-weight events carrying the same statistical information,
+   *  - the unweighting efficiency <w>/w_max, the fraction of events kept
+   *    when unweighting by hit-or-miss against the maximum weight, and the
+   *    same against the k-th largest weight, which shows how much a few
+   *    outliers cost.
+   *
+   * The work per event is constant, a logarithm for the bin and a comparison
+   * with the smallest of the top k. Only events entering the top k are
+   * copied, into preallocated slots.
+   *
+   * The results serialize into a fixed number of doubles, every top event
+   * takes a record of max_stored_particles particles, so events with more
+   * outgoing particles than that cannot be shipped between processes.
+   */
+  struct weight_monitor : analyser {
+
+    /** \brief Incoming and outgoing particles of a serialized top event.
+     */
+    static const size_type max_stored_particles = 10;
+
+    /** \brief Bins of |weight|.
+     */
+    axis _M_axis;
+
+    /** \brief Number of events and sum of weights per bin, the last two
+     * entries are underflow and overflow.
+     */
+    std::vector<size_type>  _M_counts;
+    std::vector<value_type> _M_sums;
+
+    /** \brief Events with zero and with negative weight.
+     */
+    size_type _M_number_of_zeros, _M_number_of_negatives;
+
+    /** \brief Sums of weights and squared weights.
+     */
+    value_type _M_weight_sum, _M_weight2_sum;
+
+    /** \brief The top weights as a min-heap of (|weight|, slot) pairs, the
+     * smallest of the top weights is at the front.
+     */
+    std::vector<std::pair<value_type, size_type> > _M_top;
+
+    /** \brief Number of top weights to keep.
+     */
+    size_type _M_k;
+
+    /** \brief Weights and events of the slots.
+     */
+    std::vector<value_type> _M_top_weights;
+    std::vector<event>      _M_top_events;
+
+    /** \brief Monitor with n_bins logarithmic bins between w_min and w_max,
+     * keeping the k largest weights.
+     */
+    explicit weight_monitor(
+      value_type w_min  = 1e-16,
+      value_type w_max  = 1.0,
+      size_type  n_bins = 64,
+      size_type  k      = 10
+    );
+
+    weight_monitor(const weight_monitor &) = default;
+
+    virtual ~weight_monitor() {
+    }
+
+    weight_monitor & operator = (const weight_monitor &) = default;
+
+    /** \brief Analyze an event.
+     */
+    void analyze(const event & ev, value_type weight) {
+
+      _M_weight_sum  += weight;
+      _M_weight2_sum += weight*weight;
+
+      if (weight == 0.0) {
+        ++_M_number_of_zeros;
+        return;
+      }
+
+      if (weight < 0.0) { ++_M_number_of_negatives; }
+
+      value_type w = std::fabs(weight);
+      size_type  k;
+
+      if (!_M_axis.index(w, k)) {
+        k = _M_axis.size() + (w < _M_axis.lower(0) ? 0 : 1);
+      }
+
+      ++_M_counts[k];
+      _M_sums[k] += weight;
+
+      if (_M_top.size() < _M_k || w > _M_top.front().first) {
+        _M_insert_top(ev, weight);
+      }
+    }
+
+    /** \brief Effective sample size (sum w)^2/(sum w^2).
+     */
+    value_type effective_sample_size() const {
+      return _M_weight2_sum > 0.0 ? _M_weight_sum*_M_weight_sum/_M_weight2_sum : 0.0;
+    }
+
+    /** \brief Largest |weight|, 0 before the first nonzero weight.
+     */
+    value_type maximum_weight() const;
+
+    /** \brief Unweighting efficiency <w>/w_max, with the n-th largest weight
+     * as w_max (n = 1 is the maximum, n = k the smallest of the top k).
+     */
+    value_type unweighting_efficiency(size_type n = 1) const;
+
+    /** \brief The top weights and their events, largest first.
+     */
+    std::vector<std::pair<value_type, const event *> > top() const;
+
+    /** \brief A new monitor with the same binning and no results.
+     */
+    weight_monitor * clone() const;
+
+    /** \brief Add the results of another weight_monitor with the same
+     * binning, the top weights are the largest of both.
+     */
+    void merge_results(const analyser &);
+
+    /** \brief The bins, the counters, the sums and the top weights with
+     * their events.
+     */
+    size_type results_size() const;
+
+    void store_results(value_type *) const;
+
+    /** \brief Add the results written by store_results() of a monitor with
+     * the same binning and k.
+     */
+    void add_results(const value_type *);
+
+    /** \brief Print the result.
+     */
+    std::ostream & print(std::ostream &) const;
+
+  private:
+
+    /** \brief Put an event among the top weights.
+     */
+    void _M_insert_top(const event &, value_type);
+
+  }; // end of struct weight_monitor
+
+} // end of namespace school
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * \file
+ * \brief Implementation of work_stealing_scheduler members.
+ */
+
+#include "work-stealing.h"
+
+#include <thread>
+
+namespace school {
+
+  work_stealing_scheduler::work_stealing_scheduler(size_type n) :
+  _M_number_of_steals(0),
+  _M_failed          (false) {
+    for (size_type w = 0; w < (n > 0 ? n : 1); w++) {
+      _M_queues.push_back(std::unique_ptr<worker_queue>(new worker_queue));
+    }
+  }
+
+  bool work_stealing_scheduler::_M_next(size_type worker, size_type & task) {
+
+    //----- own work from the front -----
+    {
+      worker_queue & q = *_M_queues[worker];
+      std::lock_guard<std::mutex> guard(q.lock);
+      if (!q.tasks.empty()) {
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        return true;
+      }
+    }
+
+    //----- steal from the back of the others, starting with the neighbour -----
+    for (size_type k = 1; k < _M_queues.size(); k++) {
+      worker_queue & q = *_M_queues[(worker + k) % _M_queues.size()];
+      std::lock_guard<std::mutex> guard(q.lock);
+      if (!q.tasks.empty()) {
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        ++_M_number_of_steals;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  void work_stealing_scheduler::run(
+    size_type                               n,
+    const task_function                   & task,
+    const std::function<void (size_type)> & start,
+    const std::function<void (size_type)> & finish
+  ) {
+
+    const size_type nw = _M_queues.size();
+
+    _M_number_of_steals = 0;
+    _M_failed           = false;
+    _M_error            = std::exception_ptr();
+
+    // contiguous ranges of tasks for the workers
+    for (size_type w = 0; w < nw; w++) {
+      for (size_type t = w*n/nw; t < (w+1)*n/nw; t++) {
+        _M_queues[w]->tasks.push_back(t);
+      }
+    }
+
+    std::vector<std::thread> threads;
+
+    for (size_type w = 0; w < nw; w++) {
+      threads.push_back(std::thread([this, w, &task, &start, &finish] () {
+        // an exception must not leave the thread, it is handed to run()
+        try {
+          if (start) { start(w); }
+          size_type t;
+          while (!_M_failed && _M_next(w, t)) {
+            task(w, t);
+          }
+          if (finish) { finish(w); }
+        } catch (...) {
+          std::lock_guard<std::mutex> guard(_M_error_lock);
+          if (!_M_error) { _M_error = std::current_exception(); }
+          _M_failed = true;
+        }
+      }));
+    }
+
+    for (auto & t : threads) {
+      t.join();
+    }
+
+    // leave the deques empty for the next run
+    for (auto & q : _M_queues) {
+      q->tasks.clear();
+    }
+
+    if (_M_error) { std::rethrow_exception(_M_error); }
+  }
+
+} // end of namespace school
@@ -0,0 +1,110 @@
+/**
+ * \file
+ * \brief Definition of the work_stealing_scheduler class.
+ */
+
+#ifndef __SCHOOL_WORK_STEALING_H__
+#define __SCHOOL_WORK_STEALING_H__ 1
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace school {
+
+  /** \brief Runs numbered tasks on a fixed number of worker threads.
+   *
+   * At the start every worker gets a contiguous range of the tasks in its own
+   * deque. A worker takes its tasks from the front of its deque. When it runs
+   * out of work, it steals from the back of the other deques, so the workers
+   * stay busy until the very end even if the tasks take very different
+   * times. The tasks are independent and do not create new tasks, so the run
+   * is over as soon as every deque is empty.
+   */
+  class work_stealing_scheduler {
+
+  public:
+
+    typedef std::size_t size_type;
+
+    /** \brief The task body, called with the worker and the task number.
+     */
+    typedef std::function<void (size_type, size_type)> task_function;
+
+  private:
+
+    /** \brief Deque of a worker, on its own cache lines.
+     */
+    struct worker_queue {
+      char                  pad0[64];
+      std::mutex            lock;
+      std::deque<size_type> tasks;
+      char                  pad1[64];
+    };
+
+    std::vector<std::unique_ptr<worker_queue> > _M_queues;
+
+    /** \brief Number of tasks run by a worker other than their owner.
+     */
+    std::atomic<size_type> _M_number_of_steals;
+
+    /** \brief Set when a worker failed, the others stop at their next task.
+     */
+    std::atomic<bool> _M_failed;
+
+    /** \brief The first exception thrown in a worker.
+     */
+    std::exception_ptr _M_error;
+    std::mutex         _M_error_lock;
+
+  public:
+
+    /** \brief Scheduler with n worker threads.
+     */
+    explicit work_stealing_scheduler(size_type n);
+
+    work_stealing_scheduler(const work_stealing_scheduler &)               = delete;
+    work_stealing_scheduler & operator = (const work_stealing_scheduler &) = delete;
+
+    /** \brief Number of worker threads.
+     */
+    size_type number_of_workers() const {
+      return _M_queues.size();
+    }
+
+    /** \brief Number of stolen tasks in the last run.
+     */
+    size_type number_of_steals() const {
+      return _M_number_of_steals.load();
+    }
+
+    /** \brief Run the tasks 0..n-1 and wait for them.
+     *
+     * Every worker calls start(worker) in its own thread before its first
+     * task, and finish(worker) after its last one. If start, task or finish
+     * throws, the workers stop taking tasks, and the first exception is
+     * rethrown here after all threads are joined.
+     */
+    void run(
+      size_type             n,
+      const task_function & task,
+      const std::function<void (size_type)> & start  = std::function<void (size_type)>(),
+      const std::function<void (size_type)> & finish = std::function<void (size_type)>()
+    );
+
+  private:
+
+    /** \brief Next task for a worker, false if there is no work anywhere.
+     */
+    bool _M_next(size_type worker, size_type & task);
+
+  }; // end of class work_stealing_scheduler
+
+} // end of namespace school
+
+#endif